@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+
+// A value field backed by a relaxed atomic, for state written under a lock by one
+// thread and read without it by others (reference bits, page-table entries).
+// Copies read the current value, so structs of these stay copyable aggregates.
+template <typename T>
+class AtomicField {
+public:
+    AtomicField(T initial = T()) : value(initial) {}
+    AtomicField(const AtomicField& other) : value(other.load()) {}
+
+    AtomicField& operator=(const AtomicField& other) {
+        store(other.load());
+        return *this;
+    }
+    AtomicField& operator=(T newValue) {
+        store(newValue);
+        return *this;
+    }
+
+    operator T() const { return load(); }
+    T load() const { return value.load(std::memory_order_relaxed); }
+    void store(T newValue) { value.store(newValue, std::memory_order_relaxed); }
+
+private:
+    std::atomic<T> value;
+};
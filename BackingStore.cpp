@@ -0,0 +1,424 @@
+#include "BackingStore.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+BackingStore::BackingStore(const String& filename, int pageSize, int queueCapacity)
+    : filename(filename), pageSize(pageSize), queueCapacity(queueCapacity) {
+    // Page images from a previous run are meaningless to this one
+    file.open(filename, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open backing store file " << filename << ".\n";
+    }
+
+    if (queueCapacity > 0) {
+        pagerThread = std::thread(&BackingStore::pagerLoop, this);
+    }
+}
+
+BackingStore::~BackingStore() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    queueNotEmpty.notify_all();
+    if (pagerThread.joinable()) {
+        pagerThread.join();
+    }
+
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+uint64_t BackingStore::makeKey(int processId, int pageNumber) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(processId)) << 32) | static_cast<uint32_t>(pageNumber);
+}
+
+int BackingStore::claimSlot(uint64_t key) {
+    // Reuse the page's existing slot, otherwise claim a recycled or new one
+    auto it = slotIndex.find(key);
+    if (it != slotIndex.end()) {
+        return it->second;
+    }
+
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = slotCount++;
+        slotGenerations.resize(slotCount, 0);
+    }
+    slotIndex[key] = slot;
+    return slot;
+}
+
+void BackingStore::releaseSlot(int slot) {
+    freeSlots.push_back(slot);
+    slotGenerations[slot]++;
+}
+
+bool BackingStore::isSlotCurrent(int slot, int generation) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return slotGenerations[slot] == generation;
+}
+
+bool BackingStore::writePage(int processId, int pageNumber, const uint8_t* pageData) {
+    if (!file.is_open()) return false;
+
+    uint64_t key = makeKey(processId, pageNumber);
+    if (queueCapacity <= 0) {
+        // Holding the file lock from slot claim to write keeps readers, and the next owner of a
+        // recycled slot, behind this write
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        std::vector<PendingWrite> batch;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            batch.push_back({ claimSlot(key), std::vector<uint8_t>(pageData, pageData + pageSize) });
+        }
+        writeSlots(batch);
+        return static_cast<bool>(file);
+    }
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+
+    // A page already waiting in the queue is simply overwritten with the newer image
+    auto pending = pendingWrites.find(key);
+    if (pending != pendingWrites.end()) {
+        std::memcpy(pending->second.data.data(), pageData, pageSize);
+        coalescedWriteCount++;
+        return true;
+    }
+
+    // Queue full: wait for the pager to take the current batch. The slot is claimed afterwards,
+    // since a discard during the wait can recycle the page's old slot.
+    queueDrained.wait(lock, [this] { return static_cast<int>(pendingWrites.size()) < queueCapacity || stopping; });
+
+    pendingWrites[key] = { claimSlot(key), std::vector<uint8_t>(pageData, pageData + pageSize) };
+    queueNotEmpty.notify_one();
+    return true;
+}
+
+int BackingStore::claimSlotRun(int count) {
+    // Reuse a run of recycled slots if one is long enough, otherwise extend the file
+    std::sort(freeSlots.begin(), freeSlots.end());
+    for (size_t i = 0; i < freeSlots.size();) {
+        size_t j = i + 1;
+        while (j < freeSlots.size() && freeSlots[j] == freeSlots[j - 1] + 1) {
+            j++;
+        }
+        if (static_cast<int>(j - i) >= count) {
+            int first = freeSlots[i];
+            freeSlots.erase(freeSlots.begin() + i, freeSlots.begin() + i + count);
+            return first;
+        }
+        i = j;
+    }
+
+    int first = slotCount;
+    slotCount += count;
+    slotGenerations.resize(slotCount, 0);
+    return first;
+}
+
+bool BackingStore::writePages(int processId, const std::vector<int>& pageNumbers, const uint8_t* pageData) {
+    if (!file.is_open()) return false;
+    if (pageNumbers.empty()) return true;
+
+    // Synchronous batches hold the file lock from slot claim to write, like writePage
+    std::unique_lock<std::mutex> fileLock(fileMutex, std::defer_lock);
+    if (queueCapacity <= 0) {
+        fileLock.lock();
+    }
+    std::unique_lock<std::mutex> lock(stateMutex);
+    if (queueCapacity > 0) {
+        // The batch goes in whole, so it may overfill the queue until the pager takes it
+        queueDrained.wait(lock, [this] { return static_cast<int>(pendingWrites.size()) < queueCapacity || stopping; });
+    }
+
+    // Give up each page's old slot so the batch lands on one run. A page the pager is writing
+    // right now keeps its slot, or the in-flight write could land in a slot recycled by someone else.
+    std::vector<size_t> moved;
+    for (size_t i = 0; i < pageNumbers.size(); ++i) {
+        uint64_t key = makeKey(processId, pageNumbers[i]);
+        if (inFlightWrites.find(key) != inFlightWrites.end()) {
+            continue;
+        }
+        pendingWrites.erase(key);
+        auto it = slotIndex.find(key);
+        if (it != slotIndex.end()) {
+            releaseSlot(it->second);
+            slotIndex.erase(it);
+        }
+        moved.push_back(i);
+    }
+
+    int firstSlot = claimSlotRun(static_cast<int>(moved.size()));
+    std::vector<std::pair<uint64_t, PendingWrite>> batch;
+    for (size_t i = 0, m = 0; i < pageNumbers.size(); ++i) {
+        uint64_t key = makeKey(processId, pageNumbers[i]);
+        int slot;
+        if (m < moved.size() && moved[m] == i) {
+            slot = firstSlot + static_cast<int>(m++);
+            slotIndex[key] = slot;
+        }
+        else {
+            slot = claimSlot(key);
+        }
+        const uint8_t* image = pageData + i * static_cast<size_t>(pageSize);
+        batch.push_back({ key, { slot, std::vector<uint8_t>(image, image + pageSize) } });
+    }
+    batchWriteCount++;
+
+    if (queueCapacity <= 0) {
+        lock.unlock();
+        std::vector<PendingWrite> writes;
+        for (auto& [key, write] : batch) {
+            writes.push_back(std::move(write));
+        }
+        writeSlots(writes);
+        return static_cast<bool>(file);
+    }
+
+    // The pager merges the run into a single write; until then page-ins are served from the queue
+    for (auto& [key, write] : batch) {
+        pendingWrites[key] = std::move(write);
+    }
+    queueNotEmpty.notify_one();
+    return true;
+}
+
+bool BackingStore::readPage(int processId, int pageNumber, uint8_t* pageData) {
+    uint64_t key = makeKey(processId, pageNumber);
+    while (true) {
+        int slot;
+        int generation;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+
+            // Serve the page straight from the write-behind queue if it has not reached the file yet
+            for (auto* queue : { &pendingWrites, &inFlightWrites }) {
+                auto it = queue->find(key);
+                if (it != queue->end()) {
+                    std::memcpy(pageData, it->second.data.data(), pageSize);
+                    queueHitCount++;
+                    return true;
+                }
+            }
+
+            auto it = slotIndex.find(key);
+            if (it == slotIndex.end() || !file.is_open()) return false;
+            slot = it->second;
+            generation = slotGenerations[slot];
+        }
+
+        // The page was discarded or moved while this read waited for the file; look it up again
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        if (!isSlotCurrent(slot, generation)) {
+            continue;
+        }
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(slot) * pageSize);
+        file.read(reinterpret_cast<char*>(pageData), pageSize);
+        return static_cast<bool>(file);
+    }
+}
+
+int BackingStore::readPages(int processId, const std::vector<int>& pageNumbers,
+    const std::vector<uint8_t*>& pageData, std::vector<bool>& found) {
+    struct SlotRead {
+        int slot;
+        int generation;
+        uint8_t* dest;
+    };
+
+    std::vector<SlotRead> reads;
+    int foundCount;
+    std::unique_lock<std::mutex> fileLock(fileMutex, std::defer_lock);
+    while (true) {
+        found.assign(pageNumbers.size(), false);
+        reads.clear();
+        foundCount = 0;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            for (size_t i = 0; i < pageNumbers.size(); ++i) {
+                uint64_t key = makeKey(processId, pageNumbers[i]);
+
+                bool queued = false;
+                for (auto* queue : { &pendingWrites, &inFlightWrites }) {
+                    auto it = queue->find(key);
+                    if (it != queue->end()) {
+                        std::memcpy(pageData[i], it->second.data.data(), pageSize);
+                        queueHitCount++;
+                        queued = true;
+                        break;
+                    }
+                }
+                if (queued) {
+                    found[i] = true;
+                    foundCount++;
+                    continue;
+                }
+
+                auto it = slotIndex.find(key);
+                if (it != slotIndex.end() && file.is_open()) {
+                    reads.push_back({ it->second, slotGenerations[it->second], pageData[i] });
+                    found[i] = true;
+                    foundCount++;
+                }
+            }
+        }
+        if (reads.empty()) {
+            return foundCount;
+        }
+
+        // If any page was discarded or moved while this batch waited for the file, plan it again
+        fileLock.lock();
+        bool current = true;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            for (const SlotRead& read : reads) {
+                current = current && slotGenerations[read.slot] == read.generation;
+            }
+        }
+        if (current) {
+            break;
+        }
+        fileLock.unlock();
+    }
+
+    std::sort(reads.begin(), reads.end(), [](const SlotRead& a, const SlotRead& b) {
+        return a.slot < b.slot;
+        });
+
+    // Each run of consecutive slots comes in with one positioned read
+    std::vector<uint8_t> run;
+    for (size_t i = 0; i < reads.size();) {
+        size_t j = i + 1;
+        while (j < reads.size() && reads[j].slot == reads[j - 1].slot + 1) {
+            j++;
+        }
+
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(reads[i].slot) * pageSize);
+        if (j - i == 1) {
+            file.read(reinterpret_cast<char*>(reads[i].dest), pageSize);
+        }
+        else {
+            run.resize((j - i) * pageSize);
+            file.read(reinterpret_cast<char*>(run.data()), static_cast<std::streamsize>(run.size()));
+            for (size_t k = i; k < j; ++k) {
+                std::memcpy(reads[k].dest, &run[(k - i) * pageSize], pageSize);
+            }
+            coalescedReadCount += static_cast<int>(j - i - 1);
+        }
+        i = j;
+    }
+    readBatchCount++;
+    return foundCount;
+}
+
+bool BackingStore::hasPage(int processId, int pageNumber) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return slotIndex.find(makeKey(processId, pageNumber)) != slotIndex.end();
+}
+
+void BackingStore::discardPage(int processId, int pageNumber) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    uint64_t key = makeKey(processId, pageNumber);
+    auto it = slotIndex.find(key);
+    if (it != slotIndex.end()) {
+        // Forget queued copies too: a pending write could land in the slot after it is recycled,
+        // and neither may be served to a later page-in of the discarded page
+        pendingWrites.erase(key);
+        inFlightWrites.erase(key);
+        releaseSlot(it->second);
+        slotIndex.erase(it);
+        queueDrained.notify_all();
+    }
+}
+
+void BackingStore::flush() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    queueDrained.wait(lock, [this] { return (pendingWrites.empty() && inFlightWrites.empty()) || !pagerThread.joinable(); });
+}
+
+int BackingStore::getSlot(int processId, int pageNumber) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = slotIndex.find(makeKey(processId, pageNumber));
+    return (it != slotIndex.end()) ? it->second : -1;
+}
+
+int BackingStore::getSlotCount() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return slotCount;
+}
+
+int BackingStore::getUsedSlotCount() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return static_cast<int>(slotIndex.size());
+}
+
+void BackingStore::writeSlots(std::vector<PendingWrite>& batch) {
+    std::sort(batch.begin(), batch.end(), [](const PendingWrite& a, const PendingWrite& b) {
+        return a.slot < b.slot;
+        });
+
+    // Each run of consecutive slots goes out as one positioned write
+    std::vector<uint8_t> run;
+    for (size_t i = 0; i < batch.size();) {
+        size_t j = i + 1;
+        while (j < batch.size() && batch[j].slot == batch[j - 1].slot + 1) {
+            j++;
+        }
+
+        const char* data = reinterpret_cast<const char*>(batch[i].data.data());
+        if (j - i > 1) {
+            run.clear();
+            for (size_t k = i; k < j; ++k) {
+                run.insert(run.end(), batch[k].data.begin(), batch[k].data.end());
+            }
+            data = reinterpret_cast<const char*>(run.data());
+        }
+
+        file.clear();
+        file.seekp(static_cast<std::streamoff>(batch[i].slot) * pageSize);
+        file.write(data, static_cast<std::streamsize>(j - i) * pageSize);
+        i = j;
+    }
+    file.flush();
+}
+
+void BackingStore::pagerLoop() {
+    while (true) {
+        std::vector<PendingWrite> batch;
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            queueNotEmpty.wait(lock, [this] { return !pendingWrites.empty() || stopping; });
+            if (pendingWrites.empty() && stopping) {
+                break;
+            }
+
+            // Take the whole queue as one batch; it stays readable as in-flight until written
+            inFlightWrites.swap(pendingWrites);
+            for (const auto& [key, write] : inFlightWrites) {
+                batch.push_back(write);
+            }
+        }
+        queueDrained.notify_all();
+
+        {
+            std::lock_guard<std::mutex> fileLock(fileMutex);
+            writeSlots(batch);
+        }
+        batchCount++;
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            inFlightWrites.clear();
+        }
+        queueDrained.notify_all();
+    }
+}
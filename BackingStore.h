@@ -0,0 +1,92 @@
+#pragma once
+#include "TypedefRepo.h"
+#include <fstream>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Page-granular swap file. The file is an array of fixed-size slots, one page
+// image per slot; an in-memory index maps (process id, page) to its slot and
+// discarded slots are recycled, so every page-in/out is one positioned I/O.
+//
+// Page-outs are write-behind: writePage copies the page into a bounded queue
+// and returns, and a pager thread drains the queue in slot order, merging
+// runs of adjacent slots into single writes. Page-ins of a page that is still
+// queued are served from the queue. A queue capacity of 0 writes synchronously.
+// readPages does the same run-merging for batched page-ins (readahead).
+// writePages moves a batch of pages (a whole process being swapped out) onto
+// one run of consecutive slots, so it goes out, and later comes back, as one I/O.
+// Slot lookups and file I/O take different locks. Synchronous writes hold the file lock
+// from slot claim to write; reads re-check a per-slot generation, bumped on every release,
+// under the file lock, so a read never returns a slot recycled while it waited.
+class BackingStore {
+public:
+    BackingStore(const String& filename, int pageSize, int queueCapacity = 0);
+    ~BackingStore();
+
+    bool writePage(int processId, int pageNumber, const uint8_t* pageData);
+    bool writePages(int processId, const std::vector<int>& pageNumbers,  // pageData holds the images back to back
+        const uint8_t* pageData);
+    bool readPage(int processId, int pageNumber, uint8_t* pageData);
+    int readPages(int processId, const std::vector<int>& pageNumbers,   // Batched page-in; returns pages found
+        const std::vector<uint8_t*>& pageData, std::vector<bool>& found);
+    bool hasPage(int processId, int pageNumber) const;
+    void discardPage(int processId, int pageNumber);
+    void flush();                                       // Blocks until every queued write is on disk
+
+    int getSlot(int processId, int pageNumber) const;  // -1 if the page has no slot
+    int getSlotCount() const;
+    int getUsedSlotCount() const;
+
+    // Pager statistics
+    int getBatchCount() const { return batchCount.load(); }
+    int getCoalescedWriteCount() const { return coalescedWriteCount.load(); }
+    int getQueueHitCount() const { return queueHitCount.load(); }
+    int getReadBatchCount() const { return readBatchCount.load(); }
+    int getCoalescedReadCount() const { return coalescedReadCount.load(); }
+    int getBatchWriteCount() const { return batchWriteCount.load(); }     // writePages calls
+
+private:
+    struct PendingWrite {
+        int slot;
+        std::vector<uint8_t> data;
+    };
+
+    static uint64_t makeKey(int processId, int pageNumber);
+    int claimSlot(uint64_t key);                        // Assumes stateMutex held
+    int claimSlotRun(int count);                        // First of count consecutive free slots; assumes stateMutex held
+    void releaseSlot(int slot);                         // Assumes stateMutex held
+    bool isSlotCurrent(int slot, int generation) const; // False once the slot was released after generation was read
+    void writeSlots(std::vector<PendingWrite>& batch);  // Assumes fileMutex held
+    void pagerLoop();
+
+    String filename;
+    int pageSize;
+    int queueCapacity;
+    std::fstream file;
+    std::mutex fileMutex;                               // Serializes all file I/O; taken before stateMutex when both are held
+
+    // Slot index and write-behind queue (guarded by stateMutex)
+    mutable std::mutex stateMutex;
+    std::condition_variable queueNotEmpty;
+    std::condition_variable queueDrained;
+    std::unordered_map<uint64_t, int> slotIndex;        // (pid, page) -> slot
+    std::vector<int> freeSlots;                         // Slots released by discardPage
+    std::vector<int> slotGenerations;                   // Bumped on every release, so I/O planned before a recycle can tell
+    int slotCount = 0;                                  // Slots ever created (file size / pageSize)
+    std::unordered_map<uint64_t, PendingWrite> pendingWrites;   // Queued, not yet taken by the pager
+    std::unordered_map<uint64_t, PendingWrite> inFlightWrites;  // Taken by the pager, being written
+    bool stopping = false;
+
+    std::thread pagerThread;
+    std::atomic<int> batchCount{ 0 };
+    std::atomic<int> coalescedWriteCount{ 0 };
+    std::atomic<int> queueHitCount{ 0 };
+    std::atomic<int> readBatchCount{ 0 };
+    std::atomic<int> coalescedReadCount{ 0 };           // Pages that rode along in another page's read
+    std::atomic<int> batchWriteCount{ 0 };
+};
@@ -0,0 +1,345 @@
+#include "Benchmark.h"
+#include "Config.h"
+#include "MemoryManager.h"
+#include "process.h"
+#include "ReplacementPolicy.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+namespace Benchmark {
+    // Scratch backing store so benchmarks never clobber csopesy-backing-store-data.bin
+    static const String SCRATCH_STORE = "csopesy-benchmark-store.bin";
+
+    void runFaultScaling() {
+        const int frameSize = Config::getMemPerFrame();
+        const int numFrames = 32;
+        const int activeProcesses = 16;     // The only processes the timed loop touches
+        const int pagesPerProcess = 4;
+        const int accessesPerRun = 20000;
+        const int processCounts[] = { 16, 64, 256, 1024, 4096 };
+
+        std::cout << "Fault cost vs. registered processes (" << numFrames << " frames x " << frameSize << " bytes, "
+                  << accessesPerRun << " random reads over the same " << activeProcesses << " x " << pagesPerProcess
+                  << " pages per run)" << std::endl;
+        std::cout << "Processes | Faults | ns/fault" << std::endl;
+
+        std::vector<long long> costs;
+        for (int processCount : processCounts) {
+            MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE);
+
+            // The active processes come first, so their backing-store slots are the same in every run
+            std::vector<std::shared_ptr<Process>> processes;
+            processes.reserve(processCount);
+            for (int i = 0; i < processCount; ++i) {
+                auto proc = std::make_shared<Process>("bench" + std::to_string(i), i, 1, pagesPerProcess * frameSize);
+                proc->setMemoryManager(&mm);
+                mm.registerProcess(proc);
+                processes.push_back(proc);
+            }
+
+            // Untimed set-up: every idle process owns a written-back page and a page table, so a fault
+            // path that walked processes would pay for them; then the active pages are written and flushed
+            for (int i = activeProcesses; i < processCount; ++i) {
+                processes[i]->setMemoryValueAt(0, 1);
+            }
+            for (int i = 0; i < activeProcesses; ++i) {
+                for (int page = 0; page < pagesPerProcess; ++page) {
+                    processes[i]->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), static_cast<uint16_t>(page + 1));
+                }
+            }
+            mm.getBackingStore().flush();
+
+            // Same seed every run, so the touched footprint and trace are identical and only the number
+            // of registered processes changes. Reads keep the pages clean, so evictions drop frames.
+            std::mt19937 gen(42);
+            int faultsBefore = mm.getPagedInCount();
+            auto start = std::chrono::steady_clock::now();
+            for (int n = 0; n < accessesPerRun; ++n) {
+                auto& proc = processes[gen() % activeProcesses];
+                uint32_t address = static_cast<uint32_t>((gen() % pagesPerProcess) * frameSize);
+                proc->readMemoryValueAt(address);
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            int faults = mm.getPagedInCount() - faultsBefore;
+            costs.push_back(faults > 0 ? elapsed / faults : 0);
+            std::cout << std::setw(9) << processCount << " | "
+                      << std::setw(6) << faults << " | "
+                      << std::setw(8) << costs.back() << std::endl;
+        }
+
+        // Flat means within half again of the smallest run; timer noise alone stays well inside that
+        long long cheapest = *std::min_element(costs.begin(), costs.end());
+        long long dearest = *std::max_element(costs.begin(), costs.end());
+        if (cheapest > 0 && dearest * 2 <= cheapest * 3) {
+            std::cout << "Flat: fault cost does not depend on how many processes are registered." << std::endl;
+        }
+        else {
+            std::cout << "NOT flat: fault cost varies " << std::fixed << std::setprecision(1)
+                      << (cheapest > 0 ? static_cast<double>(dearest) / cheapest : 0.0)
+                      << "x with the number of registered processes." << std::endl;
+        }
+
+        std::remove(SCRATCH_STORE.c_str());
+    }
+
+    void runParallelFaults() {
+        const int frameSize = Config::getMemPerFrame();
+        const int numFrames = 64;
+        const int processesPerCore = 4;
+        const int pagesPerProcess = 32;     // Each core alone overcommits the frames twice
+        const int accessesPerCore = 20000;
+        const int coreCounts[] = { 1, 2, 4, 8 };
+
+        std::cout << "Concurrent fault throughput (" << numFrames << " frames, " << processesPerCore << " processes x "
+                  << pagesPerProcess << " pages and " << accessesPerCore << " accesses per core)" << std::endl;
+        std::cout << "Cores | Faults | Faults/sec | Speedup" << std::endl;
+
+        double baseline = 0;
+        for (int cores : coreCounts) {
+            MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE);
+
+            // Each core runs only its own processes, as the scheduler guarantees
+            std::vector<std::vector<std::shared_ptr<Process>>> owned(cores);
+            for (int core = 0; core < cores; ++core) {
+                for (int i = 0; i < processesPerCore; ++i) {
+                    int id = core * processesPerCore + i;
+                    auto proc = std::make_shared<Process>("bench" + std::to_string(id), id, 1, pagesPerProcess * frameSize);
+                    proc->setMemoryManager(&mm);
+                    mm.registerProcess(proc);
+                    owned[core].push_back(proc);
+                }
+            }
+
+            int faultsBefore = mm.getPagedInCount();
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (int core = 0; core < cores; ++core) {
+                threads.emplace_back([&, core]() {
+                    std::mt19937 gen(42 + core);
+                    for (int n = 0; n < accessesPerCore; ++n) {
+                        auto& proc = owned[core][gen() % processesPerCore];
+                        uint32_t address = static_cast<uint32_t>((gen() % pagesPerProcess) * frameSize);
+                        if (gen() % 2 == 0) {
+                            proc->setMemoryValueAt(address, static_cast<uint16_t>(n));
+                        }
+                        else {
+                            proc->readMemoryValueAt(address);
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            int faults = mm.getPagedInCount() - faultsBefore;
+            double rate = seconds > 0 ? faults / seconds : 0;
+            if (cores == 1) {
+                baseline = rate;
+            }
+            std::cout << std::setw(5) << cores << " | "
+                      << std::setw(6) << faults << " | "
+                      << std::setw(10) << std::fixed << std::setprecision(0) << rate << " | "
+                      << std::setw(6) << std::setprecision(2) << (baseline > 0 ? rate / baseline : 0) << "x" << std::endl;
+        }
+
+        std::remove(SCRATCH_STORE.c_str());
+    }
+
+    // One replayed memory reference; the trace is generated once and shared by every policy
+    struct TraceAccess {
+        int process;
+        uint32_t address;
+        bool write;
+    };
+
+    // Mix of per-process hot sets, sequential scans (which flush recency-only policies)
+    // and uniform noise, so the policies separate on scan resistance as well as locality
+    static std::vector<TraceAccess> buildPolicyTrace(int processCount, int pagesPerProcess, int frameSize, int length) {
+        const int hotPages = 4;
+        std::mt19937 gen(42);
+        std::vector<TraceAccess> trace;
+        trace.reserve(length);
+
+        auto addressOf = [&](int page) {
+            return static_cast<uint32_t>(page * frameSize + (gen() % frameSize));
+        };
+
+        while (static_cast<int>(trace.size()) < length) {
+            int pattern = gen() % 10;
+            int proc = gen() % processCount;
+            if (pattern < 8) {
+                // Hot set: the first few pages of a process
+                for (int n = 0; n < 8; ++n) {
+                    trace.push_back({ proc, addressOf(gen() % hotPages), gen() % 10 < 3 });
+                }
+            }
+            else if (pattern < 9) {
+                // Sequential scan over the whole address space, touched once
+                for (int page = 0; page < pagesPerProcess; ++page) {
+                    trace.push_back({ proc, addressOf(page), false });
+                }
+            }
+            else {
+                trace.push_back({ proc, addressOf(gen() % pagesPerProcess), gen() % 2 == 0 });
+            }
+        }
+        trace.resize(length);
+        return trace;
+    }
+
+    void runPolicyComparison() {
+        const int frameSize = Config::getMemPerFrame();
+        const int processCount = 8;
+        const int pagesPerProcess = 32;
+        const int traceLength = 50000;
+        const int frameBudgets[] = { 16, 32, 64, 128 };
+        const char* policies[] = { "clock", "lru", "wsclock", "2q", "arc" };
+
+        auto trace = buildPolicyTrace(processCount, pagesPerProcess, frameSize, traceLength);
+
+        std::cout << "Replacement policies on a seeded trace (" << processCount << " processes x "
+                  << pagesPerProcess << " pages, " << traceLength << " accesses, 1 access = 1 tick)" << std::endl;
+        std::cout << "Frames | Policy  | Faults | Fault % | Writebacks | Ticks/sec" << std::endl;
+
+        for (int numFrames : frameBudgets) {
+            for (const char* policy : policies) {
+                MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, policy);
+
+                std::vector<std::shared_ptr<Process>> processes;
+                for (int i = 0; i < processCount; ++i) {
+                    auto proc = std::make_shared<Process>("bench" + std::to_string(i), i, 1, pagesPerProcess * frameSize);
+                    proc->setMemoryManager(&mm);
+                    mm.registerProcess(proc);
+                    processes.push_back(proc);
+                }
+
+                int faultsBefore = mm.getPagedInCount();
+                auto start = std::chrono::steady_clock::now();
+                for (int n = 0; n < traceLength; ++n) {
+                    const TraceAccess& access = trace[n];
+                    if (access.write) {
+                        processes[access.process]->setMemoryValueAt(access.address, static_cast<uint16_t>(n | 1));
+                    }
+                    else {
+                        processes[access.process]->readMemoryValueAt(access.address);
+                    }
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                int faults = mm.getPagedInCount() - faultsBefore;
+                std::cout << std::setw(6) << numFrames << " | "
+                          << std::left << std::setw(7) << mm.getReplacementPolicyName() << std::right << " | "
+                          << std::setw(6) << faults << " | "
+                          << std::setw(6) << std::fixed << std::setprecision(2) << 100.0 * faults / traceLength << "% | "
+                          << std::setw(10) << mm.getWritebackCount() + mm.getPoolStoreCount() << " | "
+                          << std::setw(9) << std::setprecision(0) << (seconds > 0 ? traceLength / seconds : 0) << std::endl;
+            }
+        }
+
+        std::remove(SCRATCH_STORE.c_str());
+    }
+
+    // Steady churn of whole-process allocations: each step either admits an idle process or
+    // frees a random resident one, and fragmentation is sampled after every step
+    void runAllocatorComparison() {
+        const int frameSize = Config::getMemPerFrame();
+        const int totalMemory = 16384;
+        const int processCount = 256;
+        const int steps = 20000;
+        const char* allocators[] = { "firstfit", "buddy" };
+
+        struct Workload {
+            const char* name;
+            bool powerOfTwo;    // Sizes as createRandomProcess produces them, or arbitrary sizes
+        };
+        const Workload workloads[] = { { "pow2", true }, { "mixed", false } };
+
+        std::cout << "Allocators under process churn (" << totalMemory << " bytes, " << processCount
+                  << " processes of 64-2048 bytes, " << steps << " steps)" << std::endl;
+        std::cout << "Workload | Allocator | Allocs | Failed | Frag Fails | Used % | Ext Frag % | Int Frag % | ns/op" << std::endl;
+
+        for (const Workload& workload : workloads) {
+            for (const char* allocator : allocators) {
+                MemoryManager mm(totalMemory, frameSize, SCRATCH_STORE, Config::getPageReplacement(), allocator);
+
+                // Same seed for every allocator so both see the same process sizes and coin flips
+                std::mt19937 gen(42);
+                std::vector<String> idle;
+                std::vector<String> resident;
+                std::unordered_map<String, int> sizes;
+                for (int i = 0; i < processCount; ++i) {
+                    int size = workload.powerOfTwo ? 64 << (gen() % 6) : 64 + static_cast<int>(gen() % 1985);
+                    auto proc = std::make_shared<Process>("bench" + std::to_string(i), i, 1, size);
+                    proc->setMemoryManager(&mm);
+                    mm.registerProcess(proc);
+                    idle.push_back(proc->getName());
+                    sizes[proc->getName()] = size;
+                }
+
+                int allocs = 0;
+                int failed = 0;
+                int fragFailed = 0;     // Failures with enough free bytes, just not contiguous
+                double usedSum = 0;
+                double externalSum = 0;
+                double internalSum = 0;
+                long long elapsedNs = 0;
+
+                for (int n = 0; n < steps; ++n) {
+                    bool admit = resident.empty() || (!idle.empty() && gen() % 2 == 0);
+                    auto& from = admit ? idle : resident;
+                    size_t pick = gen() % from.size();
+                    String name = from[pick];
+
+                    auto start = std::chrono::steady_clock::now();
+                    bool moved = admit ? mm.allocateMemory(name) : mm.deallocateMemory(name);
+                    elapsedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+
+                    if (admit) {
+                        allocs++;
+                        if (!moved) {
+                            failed++;
+                            if (mm.getFreeBlockBytes() >= sizes[name]) {
+                                fragFailed++;
+                            }
+                        }
+                    }
+                    if (moved) {
+                        auto& to = admit ? resident : idle;
+                        to.push_back(name);
+                        from[pick] = from.back();
+                        from.pop_back();
+                    }
+
+                    int freeBytes = mm.getFreeBlockBytes();
+                    usedSum += 100.0 * (totalMemory - freeBytes) / totalMemory;
+                    externalSum += freeBytes > 0 ? 100.0 * mm.getExternalFragmentationBytes() / freeBytes : 0;
+                    internalSum += 100.0 * mm.getInternalFragmentationBytes() / totalMemory;
+                }
+
+                std::cout << std::left << std::setw(8) << workload.name << " | "
+                          << std::setw(9) << mm.getAllocatorName() << std::right << " | "
+                          << std::setw(6) << allocs << " | "
+                          << std::setw(6) << failed << " | "
+                          << std::setw(10) << fragFailed << " | "
+                          << std::fixed << std::setprecision(1)
+                          << std::setw(6) << usedSum / steps << " | "
+                          << std::setw(10) << externalSum / steps << " | "
+                          << std::setw(10) << internalSum / steps << " | "
+                          << std::setw(5) << std::setprecision(0) << static_cast<double>(elapsedNs) / steps << std::endl;
+            }
+        }
+
+        std::remove(SCRATCH_STORE.c_str());
+    }
+}
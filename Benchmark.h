@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedefRepo.h"
+
+// Offline micro-benchmarks for the memory subsystem. Each run builds its own
+// MemoryManager and processes, so the live emulator state is never touched.
+namespace Benchmark {
+    // Page-fault cost on a fixed working set as the number of registered processes grows
+    void runFaultScaling();
+
+    // Fault throughput with several cores faulting at once, each on its own processes
+    void runParallelFaults();
+
+    // Fault rate, writebacks and throughput of each replacement policy on one seeded trace
+    void runPolicyComparison();
+
+    // External and internal fragmentation of first-fit vs. buddy allocation under process churn
+    void runAllocatorComparison();
+}
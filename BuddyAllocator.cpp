@@ -0,0 +1,136 @@
+#include "BuddyAllocator.h"
+#include <algorithm>
+
+BuddyAllocator::BuddyAllocator(int totalSize) {
+    reset(totalSize);
+}
+
+void BuddyAllocator::reset(int totalSize) {
+    usableSize = std::max(totalSize, 0) / MIN_BLOCK_SIZE * MIN_BLOCK_SIZE;
+    maxOrder = 0;
+    while (static_cast<long long>(blockSize(maxOrder)) * 2 <= usableSize) {
+        maxOrder++;
+    }
+
+    freeLists.assign(maxOrder + 1, {});
+    allocated.clear();
+    requestedBytes = 0;
+
+    // Largest aligned blocks first, so every top-level block starts on a multiple of its size
+    int address = 0;
+    for (int order = maxOrder; order >= 0; --order) {
+        if (usableSize - address >= blockSize(order)) {
+            freeLists[order].insert(address);
+            address += blockSize(order);
+        }
+    }
+    freeBytes = address;
+}
+
+int BuddyAllocator::orderFor(int size) {
+    int order = 0;
+    while ((static_cast<long long>(MIN_BLOCK_SIZE) << order) < size) {
+        order++;
+    }
+    return order;
+}
+
+int BuddyAllocator::allocate(int size) {
+    if (size <= 0) {
+        return -1;
+    }
+
+    int order = orderFor(size);
+    int from = order;
+    while (from <= maxOrder && freeLists[from].empty()) {
+        from++;
+    }
+    if (from > maxOrder) {
+        return -1;
+    }
+
+    int address = *freeLists[from].begin();
+    freeLists[from].erase(freeLists[from].begin());
+
+    // Split down to the requested order, keeping the lower half and freeing the upper one
+    while (from > order) {
+        from--;
+        freeLists[from].insert(address + blockSize(from));
+    }
+
+    allocated[address] = { order, size };
+    freeBytes -= blockSize(order);
+    requestedBytes += size;
+    return address;
+}
+
+bool BuddyAllocator::release(int startAddress) {
+    auto it = allocated.find(startAddress);
+    if (it == allocated.end()) {
+        return false;
+    }
+
+    int order = it->second.order;
+    freeBytes += blockSize(order);
+    requestedBytes -= it->second.requested;
+    allocated.erase(it);
+
+    // Coalesce upward while the buddy at this order is free
+    int address = startAddress;
+    while (order < maxOrder) {
+        int buddy = address ^ blockSize(order);
+        auto buddyIt = freeLists[order].find(buddy);
+        if (buddyIt == freeLists[order].end()) {
+            break;
+        }
+        freeLists[order].erase(buddyIt);
+        address = std::min(address, buddy);
+        order++;
+    }
+    freeLists[order].insert(address);
+    return true;
+}
+
+bool BuddyAllocator::canAllocate(int size) const {
+    if (size <= 0) {
+        return false;
+    }
+    for (int order = orderFor(size); order <= maxOrder; ++order) {
+        if (!freeLists[order].empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int BuddyAllocator::getLargestFreeBlock() const {
+    for (int order = maxOrder; order >= 0; --order) {
+        if (!freeLists[order].empty()) {
+            return blockSize(order);
+        }
+    }
+    return 0;
+}
+
+int BuddyAllocator::getInternalFragmentation() const {
+    return usableSize - freeBytes - requestedBytes;
+}
+
+std::vector<std::pair<int, int>> BuddyAllocator::getFreeBlocks() const {
+    std::vector<std::pair<int, int>> blocks;
+    for (int order = 0; order <= maxOrder; ++order) {
+        for (int address : freeLists[order]) {
+            blocks.push_back({ address, blockSize(order) });
+        }
+    }
+    std::sort(blocks.begin(), blocks.end());
+    return blocks;
+}
+
+std::vector<std::pair<int, int>> BuddyAllocator::getAllocatedBlocks() const {
+    std::vector<std::pair<int, int>> blocks;
+    for (const auto& [address, allocation] : allocated) {
+        blocks.push_back({ address, blockSize(allocation.order) });
+    }
+    return blocks;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Binary buddy allocator over the address range [0, totalSize). Requests round up
+// to a power of two of at least MIN_BLOCK_SIZE. Each order keeps an address-ordered
+// free list: allocation splits the smallest free block that fits, and a release
+// merges with its buddy (address XOR block size) for as long as the buddy is free.
+// A total that is not a power of two is carved into several top-level blocks.
+class BuddyAllocator {
+public:
+    static const int MIN_BLOCK_SIZE = 64;  // Same 2^6 floor process sizes are rounded to
+
+    explicit BuddyAllocator(int totalSize = 0);
+
+    void reset(int totalSize);              // Frees everything
+
+    int allocate(int size);                 // Returns the block's start address, -1 if no block fits
+    bool release(int startAddress);         // false if no block is allocated at startAddress
+    bool canAllocate(int size) const;
+
+    int getFreeBytes() const { return freeBytes; }
+    int getLargestFreeBlock() const;
+    int getInternalFragmentation() const;   // Bytes lost to rounding requests up to a block size
+
+    std::vector<std::pair<int, int>> getFreeBlocks() const;      // (start, size), address order
+    std::vector<std::pair<int, int>> getAllocatedBlocks() const; // (start, size), address order
+
+private:
+    struct Allocation {
+        int order;
+        int requested;
+    };
+
+    static int blockSize(int order) { return MIN_BLOCK_SIZE << order; }
+    static int orderFor(int size);
+
+    int usableSize = 0;                     // totalSize rounded down to MIN_BLOCK_SIZE
+    int maxOrder = 0;
+    int freeBytes = 0;
+    int requestedBytes = 0;
+
+    std::vector<std::set<int>> freeLists;   // freeLists[order] = start addresses of free blocks
+    std::map<int, Allocation> allocated;    // startAddress -> block
+};
@@ -0,0 +1,216 @@
+#include "CompressedPool.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    void appendWord(std::vector<uint8_t>& out, uint16_t word) {
+        uint8_t bytes[sizeof(word)];
+        std::memcpy(bytes, &word, sizeof(word));
+        out.insert(out.end(), bytes, bytes + sizeof(word));
+    }
+
+    uint16_t readWord(const uint8_t* data) {
+        uint16_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+    // (count, value) pairs for each run of equal words
+    void appendRuns(std::vector<uint8_t>& out, const std::vector<uint16_t>& words, size_t first) {
+        for (size_t i = first; i < words.size();) {
+            size_t j = i + 1;
+            while (j < words.size() && words[j] == words[i] && j - i < UINT16_MAX) {
+                j++;
+            }
+            appendWord(out, static_cast<uint16_t>(j - i));
+            appendWord(out, words[i]);
+            i = j;
+        }
+    }
+}
+
+CompressedPool::CompressedPool(BackingStore& lowerTier, int pageSize, int capacityBytes)
+    : lowerTier(lowerTier), pageSize(pageSize), capacityBytes(capacityBytes) {
+}
+
+uint64_t CompressedPool::makeKey(int processId, int pageNumber) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(processId)) << 32) | static_cast<uint32_t>(pageNumber);
+}
+
+bool CompressedPool::encode(const uint8_t* pageData, std::vector<uint8_t>& out) const {
+    if (pageSize % 2 != 0) {
+        return false;
+    }
+
+    size_t wordCount = pageSize / 2;
+    std::vector<uint16_t> words(wordCount);
+    for (size_t i = 0; i < wordCount; ++i) {
+        words[i] = readWord(pageData + i * 2);
+    }
+
+    out.clear();
+    bool sameValue = std::all_of(words.begin(), words.end(), [&](uint16_t w) { return w == words[0]; });
+    if (sameValue) {
+        out.push_back(SameValue);
+        appendWord(out, words[0]);
+        return true;
+    }
+
+    std::vector<uint8_t> runs;
+    runs.push_back(RunLength);
+    appendRuns(runs, words, 0);
+
+    // Arithmetic sequences collapse to a single run once each word is replaced by its step
+    std::vector<uint16_t> deltas(wordCount);
+    deltas[0] = words[0];
+    for (size_t i = 1; i < wordCount; ++i) {
+        deltas[i] = static_cast<uint16_t>(words[i] - words[i - 1]);
+    }
+    std::vector<uint8_t> deltaRuns;
+    deltaRuns.push_back(DeltaRuns);
+    appendWord(deltaRuns, deltas[0]);
+    appendRuns(deltaRuns, deltas, 1);
+
+    out = runs.size() <= deltaRuns.size() ? std::move(runs) : std::move(deltaRuns);
+
+    // Not worth keeping in RAM unless it saves at least a quarter of the page
+    return static_cast<int>(out.size()) <= pageSize * 3 / 4;
+}
+
+void CompressedPool::decode(const std::vector<uint8_t>& in, uint8_t* pageData) const {
+    size_t wordCount = pageSize / 2;
+    const uint8_t* payload = in.data() + 1;
+    size_t payloadSize = in.size() - 1;
+
+    auto writeRuns = [&](size_t offset, size_t word, bool accumulate, uint16_t previous) {
+        for (; offset + 4 <= payloadSize && word < wordCount; offset += 4) {
+            uint16_t count = readWord(payload + offset);
+            uint16_t value = readWord(payload + offset + 2);
+            for (uint16_t n = 0; n < count && word < wordCount; ++n, ++word) {
+                previous = accumulate ? static_cast<uint16_t>(previous + value) : value;
+                std::memcpy(pageData + word * 2, &previous, sizeof(previous));
+            }
+        }
+    };
+
+    switch (in[0]) {
+    case SameValue: {
+        uint16_t value = readWord(payload);
+        for (size_t i = 0; i < wordCount; ++i) {
+            std::memcpy(pageData + i * 2, &value, sizeof(value));
+        }
+        break;
+    }
+    case RunLength:
+        writeRuns(0, 0, false, 0);
+        break;
+    case DeltaRuns: {
+        uint16_t first = readWord(payload);
+        std::memcpy(pageData, &first, sizeof(first));
+        writeRuns(2, 1, true, first);
+        break;
+    }
+    }
+}
+
+bool CompressedPool::store(int processId, int pageNumber, const uint8_t* pageData) {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    // Encode before locking; only the index update is serialized
+    std::vector<uint8_t> encoded;
+    uint64_t key = makeKey(processId, pageNumber);
+    bool accepted = encode(pageData, encoded) && static_cast<int>(encoded.size()) <= capacityBytes;
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    discardLocked(key);
+    if (!accepted) {
+        rejectCount++;
+        return false;
+    }
+
+    // Make room by pushing the least recently stored pages down to the file
+    while (usedBytes + static_cast<int>(encoded.size()) > capacityBytes && !lru.empty()) {
+        spillOldest();
+    }
+
+    lru.push_front(key);
+    usedBytes += static_cast<int>(encoded.size());
+    entries[key] = { std::move(encoded), lru.begin() };
+    storedPageCount++;
+    storeCount++;
+    return true;
+}
+
+bool CompressedPool::load(int processId, int pageNumber, uint8_t* pageData) {
+    if (!isEnabled()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(poolMutex);
+    auto it = entries.find(makeKey(processId, pageNumber));
+    if (it == entries.end()) {
+        return false;
+    }
+
+    decode(it->second.data, pageData);
+    erase(it);
+    hitCount++;
+    return true;
+}
+
+bool CompressedPool::peek(int processId, int pageNumber, uint8_t* pageData) const {
+    if (!isEnabled()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(poolMutex);
+    auto it = entries.find(makeKey(processId, pageNumber));
+    if (it == entries.end()) {
+        return false;
+    }
+
+    decode(it->second.data, pageData);
+    return true;
+}
+
+bool CompressedPool::contains(int processId, int pageNumber) const {
+    if (!isEnabled()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return entries.find(makeKey(processId, pageNumber)) != entries.end();
+}
+
+void CompressedPool::discard(int processId, int pageNumber) {
+    if (!isEnabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(poolMutex);
+    discardLocked(makeKey(processId, pageNumber));
+}
+
+void CompressedPool::discardLocked(uint64_t key) {
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        erase(it);
+    }
+}
+
+void CompressedPool::erase(std::unordered_map<uint64_t, Entry>::iterator it) {
+    usedBytes -= static_cast<int>(it->second.data.size());
+    storedPageCount--;
+    lru.erase(it->second.lruPosition);
+    entries.erase(it);
+}
+
+void CompressedPool::spillOldest() {
+    uint64_t key = lru.back();
+    auto it = entries.find(key);
+
+    std::vector<uint8_t> page(pageSize);
+    decode(it->second.data, page.data());
+    lowerTier.writePage(static_cast<int>(key >> 32), static_cast<int>(key & 0xFFFFFFFFu), page.data());
+
+    erase(it);
+    spillCount++;
+}
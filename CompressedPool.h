@@ -0,0 +1,72 @@
+#pragma once
+#include "TypedefRepo.h"
+#include "BackingStore.h"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Compressed in-memory swap tier in front of the BackingStore file (zram-style).
+// Dirty evicted pages are encoded with a small uint16-aware codec (same-value,
+// run-length, or run-length over deltas) and kept in a byte-bounded pool. When
+// the pool is full the least recently stored pages spill to the BackingStore.
+// A page-in served from the pool removes the entry; the page comes back dirty
+// so its next eviction stores it again. A capacity of 0 disables the tier.
+// All operations are thread-safe; spills call into the BackingStore with the pool lock held.
+class CompressedPool {
+public:
+    CompressedPool(BackingStore& lowerTier, int pageSize, int capacityBytes);
+
+    bool isEnabled() const { return capacityBytes > 0; }
+
+    bool store(int processId, int pageNumber, const uint8_t* pageData); // false if disabled or incompressible
+    bool load(int processId, int pageNumber, uint8_t* pageData);        // Removes the entry on success
+    bool peek(int processId, int pageNumber, uint8_t* pageData) const;  // Leaves the entry in place
+    bool contains(int processId, int pageNumber) const;
+    void discard(int processId, int pageNumber);
+
+    // Statistics
+    int getStoredPageCount() const { return storedPageCount.load(); }
+    int getUsedBytes() const { return usedBytes.load(); }
+    int getCapacityBytes() const { return capacityBytes; }
+    int getStoreCount() const { return storeCount.load(); }
+    int getHitCount() const { return hitCount.load(); }
+    int getSpillCount() const { return spillCount.load(); }
+    int getRejectCount() const { return rejectCount.load(); }
+
+private:
+    enum Encoding : uint8_t {
+        SameValue,  // One uint16 repeated across the page
+        RunLength,  // (count, value) uint16 pairs
+        DeltaRuns   // (count, delta) pairs over successive word differences
+    };
+
+    struct Entry {
+        std::vector<uint8_t> data;              // Encoding tag followed by the payload
+        std::list<uint64_t>::iterator lruPosition;
+    };
+
+    static uint64_t makeKey(int processId, int pageNumber);
+    bool encode(const uint8_t* pageData, std::vector<uint8_t>& out) const;
+    void decode(const std::vector<uint8_t>& in, uint8_t* pageData) const;
+    void discardLocked(uint64_t key);
+    void erase(std::unordered_map<uint64_t, Entry>::iterator it);
+    void spillOldest();
+
+    BackingStore& lowerTier;
+    int pageSize;
+    int capacityBytes;
+
+    mutable std::mutex poolMutex;                  // Guards entries and lru
+    std::unordered_map<uint64_t, Entry> entries;   // (pid, page) -> compressed image
+    std::list<uint64_t> lru;                       // Most recently stored at the front
+
+    std::atomic<int> usedBytes{ 0 };
+    std::atomic<int> storedPageCount{ 0 };
+    std::atomic<int> storeCount{ 0 };
+    std::atomic<int> hitCount{ 0 };
+    std::atomic<int> spillCount{ 0 };
+    std::atomic<int> rejectCount{ 0 };
+};
@@ -23,6 +23,26 @@ namespace Config {
 
         g_config.minMemPerProc = 64;
         g_config.maxMemPerProc = 1024;
+
+        g_config.pagerQueueSize = 64;
+        g_config.pageFaultLatency = 0;
+        g_config.pageReplacement = "clock";
+        g_config.readaheadWindow = 0;
+        g_config.workingSetWindow = 0;
+        g_config.compressedPoolSize = 0;
+        g_config.memoryAllocator = "firstfit";
+        g_config.tlbEntries = 16;
+        g_config.hugePageSize = 0;
+        g_config.hugePageThreshold = 4096;
+        g_config.programVariants = 0;
+        g_config.mergeScanPages = 0;
+        g_config.swapResidency = 0;
+        g_config.localityLookahead = 0;
+        g_config.migrationPenalty = 0;
+        g_config.runQueues = "shared";
+        g_config.balancePeriod = 20;
+        g_config.balanceQueueThreshold = 2;
+        g_config.balanceWorkThreshold = 1000;
         g_initialized = true;
     }
 
@@ -85,6 +105,75 @@ namespace Config {
                 else if (key == "max-mem-per-proc") {
                     g_config.maxMemPerProc = std::stoi(value);
                 }
+                else if (key == "pager-queue-size") {
+                    g_config.pagerQueueSize = std::stoi(value);
+                }
+                else if (key == "page-fault-latency") {
+                    g_config.pageFaultLatency = std::stoi(value);
+                }
+                else if (key == "page-replacement") {
+                    // Remove quotes if present
+                    if (value.front() == '"' && value.back() == '"') {
+                        value = value.substr(1, value.length() - 2);
+                    }
+                    g_config.pageReplacement = value;
+                }
+                else if (key == "readahead-window") {
+                    g_config.readaheadWindow = std::stoi(value);
+                }
+                else if (key == "working-set-window") {
+                    g_config.workingSetWindow = std::stoi(value);
+                }
+                else if (key == "compressed-pool-size") {
+                    g_config.compressedPoolSize = std::stoi(value);
+                }
+                else if (key == "memory-allocator") {
+                    // Remove quotes if present
+                    if (value.front() == '"' && value.back() == '"') {
+                        value = value.substr(1, value.length() - 2);
+                    }
+                    g_config.memoryAllocator = value;
+                }
+                else if (key == "tlb-entries") {
+                    g_config.tlbEntries = std::stoi(value);
+                }
+                else if (key == "huge-page-size") {
+                    g_config.hugePageSize = std::stoi(value);
+                }
+                else if (key == "huge-page-threshold") {
+                    g_config.hugePageThreshold = std::stoi(value);
+                }
+                else if (key == "program-variants") {
+                    g_config.programVariants = std::stoi(value);
+                }
+                else if (key == "merge-scan-pages") {
+                    g_config.mergeScanPages = std::stoi(value);
+                }
+                else if (key == "swap-residency") {
+                    g_config.swapResidency = std::stoi(value);
+                }
+                else if (key == "locality-lookahead") {
+                    g_config.localityLookahead = std::stoi(value);
+                }
+                else if (key == "migration-penalty") {
+                    g_config.migrationPenalty = std::stoi(value);
+                }
+                else if (key == "run-queues") {
+                    // Remove quotes if present
+                    if (value.front() == '"' && value.back() == '"') {
+                        value = value.substr(1, value.length() - 2);
+                    }
+                    g_config.runQueues = value;
+                }
+                else if (key == "balance-period") {
+                    g_config.balancePeriod = std::stoi(value);
+                }
+                else if (key == "balance-queue-threshold") {
+                    g_config.balanceQueueThreshold = std::stoi(value);
+                }
+                else if (key == "balance-work-threshold") {
+                    g_config.balanceWorkThreshold = std::stoi(value);
+                }
             }
         }
         
@@ -105,6 +194,25 @@ namespace Config {
     
         std::cout << "  min-mem-per-proc: " << g_config.minMemPerProc << std::endl;
         std::cout << "  max-mem-per-proc: " << g_config.maxMemPerProc << std::endl;
+        std::cout << "  pager-queue-size: " << g_config.pagerQueueSize << std::endl;
+        std::cout << "  page-fault-latency: " << g_config.pageFaultLatency << std::endl;
+        std::cout << "  page-replacement: " << g_config.pageReplacement << std::endl;
+        std::cout << "  readahead-window: " << g_config.readaheadWindow << std::endl;
+        std::cout << "  working-set-window: " << g_config.workingSetWindow << std::endl;
+        std::cout << "  compressed-pool-size: " << g_config.compressedPoolSize << std::endl;
+        std::cout << "  memory-allocator: " << g_config.memoryAllocator << std::endl;
+        std::cout << "  tlb-entries: " << g_config.tlbEntries << std::endl;
+        std::cout << "  huge-page-size: " << g_config.hugePageSize << std::endl;
+        std::cout << "  huge-page-threshold: " << g_config.hugePageThreshold << std::endl;
+        std::cout << "  program-variants: " << g_config.programVariants << std::endl;
+        std::cout << "  merge-scan-pages: " << g_config.mergeScanPages << std::endl;
+        std::cout << "  swap-residency: " << g_config.swapResidency << std::endl;
+        std::cout << "  locality-lookahead: " << g_config.localityLookahead << std::endl;
+        std::cout << "  migration-penalty: " << g_config.migrationPenalty << std::endl;
+        std::cout << "  run-queues: " << g_config.runQueues << std::endl;
+        std::cout << "  balance-period: " << g_config.balancePeriod << std::endl;
+        std::cout << "  balance-queue-threshold: " << g_config.balanceQueueThreshold << std::endl;
+        std::cout << "  balance-work-threshold: " << g_config.balanceWorkThreshold << std::endl;
         
         return true;
     }
@@ -126,6 +234,26 @@ namespace Config {
 
     int getMinMemPerProc() { return g_initialized ? g_config.minMemPerProc : 64; }
     int getMaxMemPerProc() { return g_initialized ? g_config.maxMemPerProc : 1024; }
+
+    int getPagerQueueSize() { return g_initialized ? g_config.pagerQueueSize : 64; }
+    int getPageFaultLatency() { return g_initialized ? g_config.pageFaultLatency : 0; }
+    String getPageReplacement() { return g_initialized ? g_config.pageReplacement : "clock"; }
+    int getReadaheadWindow() { return g_initialized ? g_config.readaheadWindow : 0; }
+    int getWorkingSetWindow() { return g_initialized ? g_config.workingSetWindow : 0; }
+    int getCompressedPoolSize() { return g_initialized ? g_config.compressedPoolSize : 0; }
+    String getMemoryAllocator() { return g_initialized ? g_config.memoryAllocator : "firstfit"; }
+    int getTlbEntries() { return g_initialized ? g_config.tlbEntries : 16; }
+    int getHugePageSize() { return g_initialized ? g_config.hugePageSize : 0; }
+    int getHugePageThreshold() { return g_initialized ? g_config.hugePageThreshold : 4096; }
+    int getProgramVariants() { return g_initialized ? g_config.programVariants : 0; }
+    int getMergeScanPages() { return g_initialized ? g_config.mergeScanPages : 0; }
+    int getSwapResidency() { return g_initialized ? g_config.swapResidency : 0; }
+    int getLocalityLookahead() { return g_initialized ? g_config.localityLookahead : 0; }
+    int getMigrationPenalty() { return g_initialized ? g_config.migrationPenalty : 0; }
+    String getRunQueues() { return g_initialized ? g_config.runQueues : "shared"; }
+    int getBalancePeriod() { return g_initialized ? g_config.balancePeriod : 20; }
+    int getBalanceQueueThreshold() { return g_initialized ? g_config.balanceQueueThreshold : 2; }
+    int getBalanceWorkThreshold() { return g_initialized ? g_config.balanceWorkThreshold : 1000; }
     
     bool isInitialized() { return g_initialized; }
 } 
\ No newline at end of file
@@ -18,6 +18,27 @@ namespace Config {
     
         int minMemPerProc;
         int maxMemPerProc;
+
+        int pagerQueueSize;     // Write-behind queue capacity in pages (0 = synchronous page-outs)
+        int pageFaultLatency;   // Ticks a faulting process waits for the pager (0 = resolve faults inline)
+        String pageReplacement; // Victim selection policy: clock, lru, wsclock, 2q or arc
+        int readaheadWindow;    // Most code pages prefetched into free frames after a sequential blocking fault (0 = no readahead)
+        int workingSetWindow;   // Working-set window in ticks for load control (0 = no load control)
+        int compressedPoolSize; // Bytes of RAM for compressed swapped-out pages (0 = no compressed tier)
+        String memoryAllocator; // Whole-process block allocator: firstfit or buddy
+        int tlbEntries;         // Translations cached per core (0 = every access walks the page table)
+        int hugePageSize;       // Bytes per huge page, a power-of-two multiple of mem-per-frame (0 = no huge pages)
+        int hugePageThreshold;  // Processes at least this many bytes map their data with huge pages
+        int programVariants;    // Distinct generated programs shared across processes (0 = one per process); a variant
+                                // fixes the length and size of scheduler-generated processes, screen -s ones share per size
+        int mergeScanPages;     // Frames the same-page merging scanner hashes per tick (0 = no merging)
+        int localityLookahead;  // Ready-queue entries RR dispatch may look past for a process with resident pages (0 = strict order)
+        int migrationPenalty;   // Ticks a process stalls refilling a cold cache after moving to another core (0 = free migration)
+        String runQueues;       // RR ready queues: shared (one for all cores) or per-core
+        int balancePeriod;      // Ticks between load-balancing passes over per-core run queues (0 = no balancing)
+        int balanceQueueThreshold; // Run-queue length difference (running process included) that triggers a move
+        int balanceWorkThreshold;  // Remaining-instruction difference that triggers a move (0 = lengths only)
+        int swapResidency;      // Ticks a process stays swapped in or out before the medium-term scheduler moves it again (0 = no swapping)
     };
 
     // Configuration management functions
@@ -41,6 +62,26 @@ namespace Config {
 
     int getMinMemPerProc();
     int getMaxMemPerProc();
+
+    int getPagerQueueSize();
+    int getPageFaultLatency();
+    String getPageReplacement();
+    int getReadaheadWindow();
+    int getWorkingSetWindow();
+    int getCompressedPoolSize();
+    String getMemoryAllocator();
+    int getTlbEntries();
+    int getHugePageSize();
+    int getHugePageThreshold();
+    int getProgramVariants();
+    int getMergeScanPages();
+    int getSwapResidency();
+    int getLocalityLookahead();
+    int getMigrationPenalty();
+    String getRunQueues();
+    int getBalancePeriod();
+    int getBalanceQueueThreshold();
+    int getBalanceWorkThreshold();
     
     // System state
     bool isInitialized();
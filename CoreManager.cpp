@@ -1,23 +1,24 @@
 #include "CoreManager.h"
+#include <algorithm>
 
-CoreManager::CoreManager(int numCores) : numCores(numCores) {
-    coreAssignments.resize(numCores, "");  // Empty strings = available
-    quantumRemaining.resize(numCores, 0);
+CoreManager::CoreManager(int numCores) : cores(std::make_unique<CoreSlot[]>(numCores)), numCores(numCores) {
 }
 
 CoreManager::~CoreManager() {
 }
 
 bool CoreManager::tryAssignProcess(int coreId, const String& processName) {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
     if (!isValidCoreId(coreId) || processName.empty()) {
         return false;
     }
+
+    CoreSlot& slot = cores[coreId];
+    std::lock_guard<std::mutex> lock(slot.nameMutex);
     
     // Only assign if core is available
-    if (coreAssignments[coreId].empty()) {
-        coreAssignments[coreId] = processName;
+    bool available = false;
+    if (slot.busy.compare_exchange_strong(available, true)) {
+        slot.processName = processName;
         return true;
     }
     
@@ -25,82 +26,82 @@ bool CoreManager::tryAssignProcess(int coreId, const String& processName) {
 }
 
 void CoreManager::clearAssignment(int coreId) {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
     if (isValidCoreId(coreId)) {
-        coreAssignments[coreId] = "";
-        quantumRemaining[coreId] = 0;
+        CoreSlot& slot = cores[coreId];
+        std::lock_guard<std::mutex> lock(slot.nameMutex);
+        slot.processName.clear();
+        slot.quantumRemaining = 0;
+        slot.busy = false;
     }
 }
 
 String CoreManager::getAssignment(int coreId) const {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
     if (isValidCoreId(coreId)) {
-        return coreAssignments[coreId];
+        return getName(cores[coreId]);
     }
     
     return "";
 }
 
 bool CoreManager::isCoreAvailable(int coreId) const {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
     if (isValidCoreId(coreId)) {
-        return coreAssignments[coreId].empty();
+        return !cores[coreId].busy.load();
     }
     
     return false;
 }
 
 void CoreManager::setQuantum(int coreId, int quantum) {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
     if (isValidCoreId(coreId)) {
-        quantumRemaining[coreId] = quantum;
+        cores[coreId].quantumRemaining = quantum;
     }
 }
 
 int CoreManager::getQuantum(int coreId) const {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
     if (isValidCoreId(coreId)) {
-        return quantumRemaining[coreId];
+        return cores[coreId].quantumRemaining.load();
     }
     
     return 0;
 }
 
 void CoreManager::decrementQuantum(int coreId) {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
-    if (isValidCoreId(coreId) && quantumRemaining[coreId] > 0) {
-        quantumRemaining[coreId]--;
+    if (isValidCoreId(coreId)) {
+        std::atomic<int>& quantum = cores[coreId].quantumRemaining;
+        int remaining = quantum.load();
+        while (remaining > 0 && !quantum.compare_exchange_weak(remaining, remaining - 1)) {
+        }
     }
 }
 
 bool CoreManager::isQuantumExpired(int coreId) const {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    
     if (isValidCoreId(coreId)) {
-        return quantumRemaining[coreId] <= 0 && !coreAssignments[coreId].empty();
+        return cores[coreId].quantumRemaining.load() <= 0 && cores[coreId].busy.load();
     }
     
     return false;
 }
 
 std::vector<String> CoreManager::getAllAssignments() const {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    return coreAssignments;
+    std::vector<String> result;
+    result.reserve(numCores);
+    
+    for (int i = 0; i < numCores; i++) {
+        result.push_back(getName(cores[i]));
+    }
+    
+    return result;
 }
 
 std::vector<String> CoreManager::getNonEmptyAssignments() const {
-    std::lock_guard<std::mutex> lock(coreMutex);
     std::vector<String> result;
     
-    for (const String& assignment : coreAssignments) {
-        if (!assignment.empty()) {
-            result.push_back(assignment);
+    for (int i = 0; i < numCores; i++) {
+        if (cores[i].busy.load()) {
+            String assignment = getName(cores[i]);
+            if (!assignment.empty()) {
+                result.push_back(assignment);
+            }
         }
     }
     
@@ -108,11 +109,10 @@ std::vector<String> CoreManager::getNonEmptyAssignments() const {
 }
 
 std::vector<int> CoreManager::getAvailableCores() const {
-    std::lock_guard<std::mutex> lock(coreMutex);
     std::vector<int> result;
     
     for (int i = 0; i < numCores; i++) {
-        if (coreAssignments[i].empty()) {
+        if (!cores[i].busy.load()) {
             result.push_back(i);
         }
     }
@@ -121,11 +121,10 @@ std::vector<int> CoreManager::getAvailableCores() const {
 }
 
 std::vector<int> CoreManager::getUsedCores() const {
-    std::lock_guard<std::mutex> lock(coreMutex);
     std::vector<int> result;
     
     for (int i = 0; i < numCores; i++) {
-        if (!coreAssignments[i].empty()) {
+        if (cores[i].busy.load()) {
             result.push_back(i);
         }
     }
@@ -138,11 +137,10 @@ int CoreManager::getCoreCount() const {
 }
 
 int CoreManager::getUsedCoreCount() const {
-    std::lock_guard<std::mutex> lock(coreMutex);
     int count = 0;
     
-    for (const String& assignment : coreAssignments) {
-        if (!assignment.empty()) {
+    for (int i = 0; i < numCores; i++) {
+        if (cores[i].busy.load()) {
             count++;
         }
     }
@@ -155,16 +153,23 @@ int CoreManager::getAvailableCoreCount() const {
 }
 
 std::vector<CoreManager::CoreInfo> CoreManager::getActiveProcessesWithQuantum() const {
-    std::lock_guard<std::mutex> lock(coreMutex);
     std::vector<CoreInfo> result;
     
     for (int i = 0; i < numCores; i++) {
-        if (!coreAssignments[i].empty()) {
+        if (!cores[i].busy.load()) {
+            continue;
+        }
+
+        // Name and quantum together, so a core cleared mid-scan is not reported
+        const CoreSlot& slot = cores[i];
+        std::lock_guard<std::mutex> lock(slot.nameMutex);
+        if (!slot.processName.empty()) {
+            int quantum = slot.quantumRemaining.load();
             result.push_back({
                 i,
-                coreAssignments[i],
-                quantumRemaining[i],
-                quantumRemaining[i] <= 0
+                slot.processName,
+                quantum,
+                quantum <= 0
             });
         }
     }
@@ -173,24 +178,68 @@ std::vector<CoreManager::CoreInfo> CoreManager::getActiveProcessesWithQuantum()
 }
 
 void CoreManager::updateQuantums() {
-    std::lock_guard<std::mutex> lock(coreMutex);
-
     for (int i = 0; i < numCores; i++) {
-        if (!coreAssignments[i].empty()) {
+        CoreSlot& slot = cores[i];
+        if (slot.busy.load()) {
             // Active core
-            activeTicks++;
-            if (quantumRemaining[i] > 0) {
-                quantumRemaining[i]--;
-            }
+            slot.activeTicks++;
+            decrementQuantum(i);
         }
         else {
             // Idle core
-            idleTicks++;
+            slot.idleTicks++;
         }
-        totalTicks++;
     }
 }
 
+int CoreManager::getActiveTicks() const {
+    int total = 0;
+    for (int i = 0; i < numCores; i++) {
+        total += cores[i].activeTicks.load();
+    }
+    return total;
+}
+
+int CoreManager::getIdleTicks() const {
+    int total = 0;
+    for (int i = 0; i < numCores; i++) {
+        total += cores[i].idleTicks.load();
+    }
+    return total;
+}
+
+int CoreManager::getTotalTicks() const {
+    return getActiveTicks() + getIdleTicks();
+}
+
+int CoreManager::getCoreActiveTicks(int coreId) const {
+    return isValidCoreId(coreId) ? cores[coreId].activeTicks.load() : 0;
+}
+
+double CoreManager::getUtilizationSpread() const {
+    double lowest = 100.0;
+    double highest = 0.0;
+    bool ticked = false;
+
+    for (int i = 0; i < numCores; i++) {
+        int active = cores[i].activeTicks.load();
+        int ticks = active + cores[i].idleTicks.load();
+        if (ticks == 0) continue;
+
+        double share = active * 100.0 / ticks;
+        lowest = std::min(lowest, share);
+        highest = std::max(highest, share);
+        ticked = true;
+    }
+
+    return ticked ? highest - lowest : 0.0;
+}
+
 bool CoreManager::isValidCoreId(int coreId) const {
     return coreId >= 0 && coreId < numCores;
-} 
\ No newline at end of file
+}
+
+String CoreManager::getName(const CoreSlot& slot) const {
+    std::lock_guard<std::mutex> lock(slot.nameMutex);
+    return slot.processName;
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include "TypedefRepo.h"
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <mutex>
 
@@ -41,21 +43,33 @@ public:
     
     std::vector<CoreInfo> getActiveProcessesWithQuantum() const;
     void updateQuantums();  // Decrements all active quantum counters
-    int getActiveTicks() const { return activeTicks; }
-    int getIdleTicks() const { return idleTicks; }
-    int getTotalTicks() const { return totalTicks; }
+    int getActiveTicks() const;     // Summed over the cores on each call
+    int getIdleTicks() const;
+    int getTotalTicks() const;
+    int getCoreActiveTicks(int coreId) const;
+    double getUtilizationSpread() const;   // Busiest minus idlest core's share of ticks spent busy, in percent
 
     
 private:
-    std::vector<String> coreAssignments;
-    std::vector<int> quantumRemaining;
-    mutable std::mutex coreMutex;
-    int numCores;
+    static const int CACHE_LINE_SIZE = 64;
 
-    int activeTicks = 0;
-    int idleTicks = 0;
-    int totalTicks = 0;
+    // Everything one core owns, padded to its own cache line so ticking one core never
+    // invalidates another's. Occupancy, quantum and tick counts are atomics read and
+    // updated without locking; the process name is a String, so it keeps a per-core lock
+    // that is only taken to assign, clear or copy it.
+    struct alignas(CACHE_LINE_SIZE) CoreSlot {
+        std::atomic<bool> busy{ false };            // Set exactly while processName is non-empty
+        std::atomic<int> quantumRemaining{ 0 };
+        std::atomic<int> activeTicks{ 0 };
+        std::atomic<int> idleTicks{ 0 };
+        mutable std::mutex nameMutex;               // Guards processName; busy changes under it too
+        String processName;
+    };
+
+    std::unique_ptr<CoreSlot[]> cores;
+    int numCores;
     
-    // Private helpers (assume lock held)
+    // Private helpers
     bool isValidCoreId(int coreId) const;
+    String getName(const CoreSlot& slot) const;
 }; 
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "FrameBitmap.h"
+#include <bit>
+
+FrameBitmap::FrameBitmap(int numFrames) {
+    reset(numFrames);
+}
+
+void FrameBitmap::reset(int frames) {
+    numFrames = frames;
+    freeCount = frames;
+    firstSummaryHint = 0;
+
+    int wordCount = (frames + BITS - 1) / BITS;
+    words = std::vector<std::atomic<uint64_t>>(wordCount);
+    summary = std::vector<std::atomic<uint64_t>>((wordCount + BITS - 1) / BITS);
+    for (int w = 0; w < wordCount; ++w) {
+        words[w] = ~0ULL;
+    }
+    for (auto& s : summary) {
+        s = 0;
+    }
+
+    // Clear the padding bits past the last frame so they are never handed out
+    if (frames % BITS != 0) {
+        words.back() = (1ULL << (frames % BITS)) - 1;
+    }
+    for (int w = 0; w < wordCount; ++w) {
+        if (words[w] != 0) {
+            summary[w / BITS] |= 1ULL << (w % BITS);
+        }
+    }
+}
+
+int FrameBitmap::allocate() {
+    int summaryCount = static_cast<int>(summary.size());
+    int startHint = firstSummaryHint;
+    for (int s = startHint; s < summaryCount; ++s) {
+        uint64_t candidates = summary[s];
+        if (candidates != 0) {
+            advanceHint(startHint, s);
+        }
+        while (candidates != 0) {
+            int w = s * BITS + std::countr_zero(candidates);
+            uint64_t bits = words[w];
+
+            // Claim the lowest free frame in the word; on a lost race, bits is reloaded and we retry
+            while (bits != 0) {
+                uint64_t remaining = bits & (bits - 1);  // Clear lowest set bit
+                if (words[w].compare_exchange_weak(bits, remaining)) {
+                    if (remaining == 0) {
+                        clearSummaryBit(w);
+                    }
+                    freeCount--;
+                    return w * BITS + std::countr_zero(bits);
+                }
+            }
+            candidates &= candidates - 1;  // Another core drained this word; try the next one
+        }
+    }
+
+    advanceHint(startHint, summaryCount);
+    return -1;
+}
+
+int FrameBitmap::allocateRun(int count) {
+    if (count <= 1) {
+        return allocate();
+    }
+    if (count >= BITS) {
+        return allocateWholeWords(count / BITS);
+    }
+
+    // Runs shorter than a word never straddle one, so a single CAS claims the whole run
+    uint64_t runMask = (1ULL << count) - 1;
+    int summaryCount = static_cast<int>(summary.size());
+    for (int s = 0; s < summaryCount; ++s) {
+        uint64_t candidates = summary[s];
+        while (candidates != 0) {
+            int w = s * BITS + std::countr_zero(candidates);
+            uint64_t bits = words[w];
+            for (int offset = 0; offset < BITS;) {
+                if (((bits >> offset) & runMask) != runMask) {
+                    offset += count;
+                    continue;
+                }
+                uint64_t remaining = bits & ~(runMask << offset);
+                if (words[w].compare_exchange_weak(bits, remaining)) {
+                    if (remaining == 0) {
+                        clearSummaryBit(w);
+                    }
+                    freeCount -= count;
+                    return w * BITS + offset;
+                }
+                offset = 0;  // Lost a race; bits was reloaded, so rescan the word
+            }
+            candidates &= candidates - 1;
+        }
+    }
+    return -1;
+}
+
+int FrameBitmap::allocateWholeWords(int wordCount) {
+    int totalWords = static_cast<int>(words.size());
+    for (int first = 0; first + wordCount <= totalWords; first += wordCount) {
+        // Claim the words one at a time and give them back if any of them is partly in use
+        int claimed = 0;
+        while (claimed < wordCount) {
+            uint64_t expected = ~0ULL;
+            if (!words[first + claimed].compare_exchange_strong(expected, 0)) {
+                break;
+            }
+            claimed++;
+        }
+        if (claimed == wordCount) {
+            for (int w = first; w < first + wordCount; ++w) {
+                clearSummaryBit(w);
+            }
+            freeCount -= wordCount * BITS;
+            return first * BITS;
+        }
+        for (int w = first; w < first + claimed; ++w) {
+            words[w] = ~0ULL;
+        }
+    }
+    return -1;
+}
+
+void FrameBitmap::release(int frameNumber) {
+    if (frameNumber < 0 || frameNumber >= numFrames) {
+        return;
+    }
+
+    int w = frameNumber / BITS;
+    uint64_t bit = 1ULL << (frameNumber % BITS);
+    if (words[w].fetch_or(bit) & bit) {
+        return;  // Already free
+    }
+    summary[w / BITS] |= 1ULL << (w % BITS);
+    lowerHint(w / BITS);
+    freeCount++;
+}
+
+bool FrameBitmap::isFree(int frameNumber) const {
+    return (words[frameNumber / BITS] >> (frameNumber % BITS)) & 1ULL;
+}
+
+void FrameBitmap::clearSummaryBit(int word) {
+    uint64_t bit = 1ULL << (word % BITS);
+    summary[word / BITS] &= ~bit;
+
+    // A release between emptying the word and clearing its bit would otherwise be invisible
+    if (words[word] != 0) {
+        summary[word / BITS] |= bit;
+        lowerHint(word / BITS);
+    }
+}
+
+void FrameBitmap::advanceHint(int from, int to) {
+    // Skip the empty summary words we just scanned, then undo it if a release landed behind us
+    if (to <= from || !firstSummaryHint.compare_exchange_strong(from, to)) {
+        return;
+    }
+    for (int s = from; s < to; ++s) {
+        if (summary[s] != 0) {
+            lowerHint(s);
+            return;
+        }
+    }
+}
+
+void FrameBitmap::lowerHint(int summaryIndex) {
+    int hint = firstSummaryHint;
+    while (summaryIndex < hint && !firstSummaryHint.compare_exchange_weak(hint, summaryIndex)) {
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <atomic>
+
+// Word-packed free-frame bitmap with a one-bit-per-word summary level.
+// A set bit means "free". Allocation finds the first free frame with two
+// count-trailing-zero lookups; occupancy counters are maintained, not counted.
+// allocate, release and the queries are lock-free: a frame is claimed by a
+// compare-and-swap on its word, and the summary is only a hint that the
+// thread emptying a word clears and re-checks, so a free frame is never hidden.
+class FrameBitmap {
+public:
+    explicit FrameBitmap(int numFrames = 0);
+
+    void reset(int numFrames);      // Marks every frame free (not safe against concurrent use)
+
+    int allocate();                 // Claims the lowest free frame, -1 if none
+    int allocateRun(int count);     // Claims count contiguous frames aligned to count (a power of two); first frame or -1
+    void release(int frameNumber);  // Returns a frame to the free pool
+    bool isFree(int frameNumber) const;
+
+    int getFreeCount() const { return freeCount.load(std::memory_order_relaxed); }
+    int getUsedCount() const { return numFrames - getFreeCount(); }
+    int size() const { return numFrames; }
+
+private:
+    static const int BITS = 64;
+
+    void clearSummaryBit(int word);  // Called by whoever emptied words[word]
+    void advanceHint(int from, int to);
+    void lowerHint(int summaryIndex);
+    int allocateWholeWords(int wordCount);
+
+    std::vector<std::atomic<uint64_t>> words;    // words[w] bit b -> frame w * 64 + b is free
+    std::vector<std::atomic<uint64_t>> summary;  // summary[s] bit b -> words[s * 64 + b] may have a free frame
+    int numFrames = 0;
+    std::atomic<int> freeCount{ 0 };
+    std::atomic<int> firstSummaryHint{ 0 };      // No summary word below this index has a set bit
+};
@@ -3,7 +3,12 @@
 #include "MainConsole.h"
 #include "ProcessConsole.h"
 #include "MemoryManager.h"
+#include "ProgramCache.h"
 #include "Config.h"
+#include "Benchmark.h"
+#ifdef _DEBUG
+#include "SelfCheck.h"
+#endif
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -11,6 +16,7 @@
 #include <cstdlib>
 #include <iomanip>
 #include <fstream>
+#include <random>
 
 MainConsole::MainConsole() : AConsole(MAIN_CONSOLE) {
     isSystemInitialized = false;
@@ -36,6 +42,8 @@ String toString(ProcessStatus status) {
     case ProcessStatus::Running: return "Running";
     case ProcessStatus::Waiting: return "Waiting";
     case ProcessStatus::Sleeping: return "Sleeping";
+    case ProcessStatus::PageFaultWait: return "PageFaultWait";
+    case ProcessStatus::Suspended: return "Suspended";
     case ProcessStatus::Finished: return "Finished";
     default: return "Unknown";
     }
@@ -106,6 +114,23 @@ bool MainConsole::handleCommand(const String& command) {
         scheduler->dumpBackingStoreToFile();
         std::cout << "Backing store dumped to csopesy-backing-store.txt\n";
     }
+    else if (cmd == "benchmark-faults") {
+        Benchmark::runFaultScaling();
+    }
+    else if (cmd == "benchmark-parallel-faults") {
+        Benchmark::runParallelFaults();
+    }
+    else if (cmd == "benchmark-policies") {
+        Benchmark::runPolicyComparison();
+    }
+    else if (cmd == "benchmark-allocators") {
+        Benchmark::runAllocatorComparison();
+    }
+#ifdef _DEBUG
+    else if (cmd == "self-check") {
+        SelfCheck::runAll();
+    }
+#endif
     else {
         showErrorMessage("Unknown command: " + command);
     }
@@ -165,9 +190,6 @@ void MainConsole::initializeSystem() {
 
     scheduler = std::make_unique<CPUScheduler>();
 
-    int coreCount = Config::getNumCpu();
-    coreManager = std::make_shared<CoreManager>(coreCount);
-
     scheduler->startCpuExecution();
 
     isSystemInitialized = true;
@@ -189,7 +211,7 @@ void MainConsole::clearConsole() {
 
 void MainConsole::handleScreenCommand(const std::vector<String>& args) {
     if (args.size() < 2) {
-        showErrorMessage("Missing screen target. Usage: screen [-s|-r|-ls] <name>");
+        showErrorMessage("Missing screen target. Usage: screen [-s|-r|-ls|-fork] <name>");
         return;
     }
 
@@ -260,6 +282,34 @@ void MainConsole::handleScreenCommand(const std::vector<String>& args) {
 
         ConsoleManager::getInstance()->switchConsole(consoleName);
     }
+    else if (args[1] == "-fork") {
+        if (args.size() != 4) {
+            showErrorMessage("Invalid command. Usage: screen -fork <source_process> <new_process>");
+            return;
+        }
+
+        String sourceName = args[2];
+        String childName = args[3];
+        if (!scheduler->hasProcess(sourceName)) {
+            showErrorMessage("Process " + sourceName + " not found.");
+            return;
+        }
+        if (scheduler->hasProcess(childName)) {
+            showErrorMessage("Process " + childName + " already exists.");
+            return;
+        }
+
+        int sharedBefore = scheduler->getMemoryManager().getForkSharedFrameCount();
+        auto child = scheduler->forkProcess(sourceName, childName);
+        if (!child) {
+            showErrorMessage("Process " + sourceName + " cannot be forked (already finished).");
+            return;
+        }
+        int shared = scheduler->getMemoryManager().getForkSharedFrameCount() - sharedBefore;
+
+        std::cout << "\033[32mProcess " << childName << " forked from " << sourceName << "!\033[0m\n";
+        std::cout << "Shared frames: " << shared << " (copy-on-write) | ID: " << child->getId() << std::endl;
+    }
     else if (args[1] == "-r") {
         if (args.size() < 3) {
             showErrorMessage("Missing process name. Usage: screen -r <process>");
@@ -358,6 +408,8 @@ void MainConsole::generateReport() {
     auto runningProcesses = scheduler->getProcessesByStatus(ProcessStatus::Running);
     auto waitingProcesses = scheduler->getProcessesByStatus(ProcessStatus::Waiting);
     auto sleepingProcesses = scheduler->getProcessesByStatus(ProcessStatus::Sleeping);
+    auto faultingProcesses = scheduler->getProcessesByStatus(ProcessStatus::PageFaultWait);
+    auto suspendedProcesses = scheduler->getProcessesByStatus(ProcessStatus::Suspended);
     auto finishedProcesses = scheduler->getProcessesByStatus(ProcessStatus::Finished);
     
     // Write running processes
@@ -392,6 +444,26 @@ void MainConsole::generateReport() {
                       << currentLine << " / " << process->getTotalInstructions() << " (sleeping)" << std::endl;
         }
     }
+
+    // Processes blocked on a page fault are waiting on the pager rather than a core
+    for (const String& processName : faultingProcesses) {
+        auto process = scheduler->getProcess(processName);
+        if (process) {
+            int currentLine = process->getTotalInstructions() - process->getRemainingInstructions();
+            reportFile << processName << "\t(" << process->getCreationTime() << ")\t"
+                      << currentLine << " / " << process->getTotalInstructions() << " (page fault)" << std::endl;
+        }
+    }
+
+    // Processes swapped out by load control until memory frees up
+    for (const String& processName : suspendedProcesses) {
+        auto process = scheduler->getProcess(processName);
+        if (process) {
+            int currentLine = process->getTotalInstructions() - process->getRemainingInstructions();
+            reportFile << processName << "\t(" << process->getCreationTime() << ")\t"
+                      << currentLine << " / " << process->getTotalInstructions() << " (suspended)" << std::endl;
+        }
+    }
     
     // Write finished processes
     reportFile << "\nFinished processes:" << std::endl;
@@ -411,18 +483,19 @@ void MainConsole::generateReport() {
 }
 
 void MainConsole::showMemoryStatus() {
-    if (!scheduler || !coreManager) {
+    if (!scheduler) {
         showUninitializedError();
         return;
     }
 
     MemoryManager& mm = scheduler->getMemoryManager();  // Get the one inside the scheduler
+    MemorySnapshot snapshot = mm.captureSnapshot();     // Consistent counters without stalling the CPU tick
 
     int totalMem = Config::getMaxOverallMem();
     int frameSize = Config::getMemPerFrame();
-    int totalPages = mm.getTotalFrames();
-    int usedPages = mm.getUsedFrameCount();
-    int freePages = mm.getFreeFrameCount();
+    int totalPages = snapshot.totalFrames;
+    int usedPages = snapshot.usedFrames;
+    int freePages = snapshot.freeFrames;
     int usedMem = usedPages * frameSize;
     int freeMem = freePages * frameSize;
 
@@ -433,6 +506,11 @@ void MainConsole::showMemoryStatus() {
     std::cout << "Total: " << totalMem << " bytes" << std::endl;
     std::cout << "Used : " << usedMem << " bytes" << std::endl;
     std::cout << "Free : " << freeMem << " bytes" << std::endl;
+    std::cout << "Allocator    : " << mm.getAllocatorName() << " (" << mm.getProcessesInMemory() << " blocks)" << std::endl;
+    std::cout << "External Frag: " << mm.getExternalFragmentationBytes() << " bytes" << std::endl;
+    std::cout << "Internal Frag: " << mm.getInternalFragmentationBytes() << " bytes" << std::endl;
+    std::cout << "Programs     : " << ProgramCache::getImageCount() << " images in " << ProgramCache::getImageBytes()
+              << " bytes (" << ProgramCache::getHitCount() << " shared loads)" << std::endl;
 
     // Pages
     std::cout << "Pages:" << std::endl;
@@ -443,19 +521,81 @@ void MainConsole::showMemoryStatus() {
 
     // CPU
     std::cout << "CPU Ticks:" << std::endl;
-    std::cout << "Active : " << coreManager->getActiveTicks() << std::endl;
-    std::cout << "Idle   : " << coreManager->getIdleTicks() << std::endl;
-    std::cout << "Total  : " << coreManager->getTotalTicks() << std::endl;
+    const CoreManager& cores = scheduler->getCoreManager();
+    std::cout << "Active : " << cores.getActiveTicks() << std::endl;
+    std::cout << "Idle   : " << cores.getIdleTicks() << std::endl;
+    std::cout << "Total  : " << cores.getTotalTicks() << std::endl;
+    std::cout << "Spread : " << std::fixed << std::setprecision(1) << cores.getUtilizationSpread()
+              << "% between busiest and idlest core" << std::endl;
+    std::cout << "Balanced: " << scheduler->getBalanceMigrationCount() << " processes moved between run queues" << std::endl;
+    std::cout << "Migrations: " << scheduler->getMigrationCount() << " (" << scheduler->getWarmupStallTicks()
+              << " ticks refilling caches)" << std::endl;
 
     // Paging
     std::cout << "\nPaging:" << std::endl;
-    std::cout << "Pages Paged In : " << mm.getPagedInCount() << std::endl;
-    std::cout << "Pages Paged Out: " << mm.getPagedOutCount() << std::endl;
+    std::cout << "Replacement    : " << mm.getReplacementPolicyName() << std::endl;
+    std::cout << "Pages Paged In : " << snapshot.pagedIn << std::endl;
+    std::cout << "Pages Paged Out: " << snapshot.pagedOut << std::endl;
+    std::cout << "Page Faults    : " << snapshot.faults << std::endl;
+    std::cout << "Readahead      : " << snapshot.readaheadPages << " pages (" << snapshot.readaheadWaste << " unused)" << std::endl;
+    std::cout << "COW Faults     : " << snapshot.cowFaults << " (" << snapshot.forkSharedFrames << " frames shared by "
+              << snapshot.forks << " forks)" << std::endl;
+    std::cout << "Shared Code    : " << snapshot.sharedCodeFrames << " frames (" << snapshot.sharedCodeMaps << " minor faults)" << std::endl;
+    std::cout << "Merged Pages   : " << snapshot.mergedPages << " pages in " << snapshot.mergedFrames << " frames ("
+              << snapshot.merges << " merges, " << snapshot.unmerges << " unmerged by writes)" << std::endl;
+    if (snapshot.hugePageSize > 0) {
+        std::cout << "Huge Pages     : " << snapshot.hugePages << " x " << snapshot.hugePageSize << " bytes ("
+                  << snapshot.hugeSplits << " split, " << snapshot.hugeFallbacks << " fallbacks)" << std::endl;
+    }
+    std::cout << "Writebacks     : " << snapshot.writebacks << " to file, " << snapshot.poolStores << " to the compressed pool, "
+              << snapshot.swapOutWrites << " in swap-out batches" << std::endl;
+    std::cout << "Clean Discards : " << snapshot.cleanDiscards << std::endl;
+    std::cout << "Zero Pages     : " << snapshot.zeroPageDrops << std::endl;
+    std::cout << "Pager Batches  : " << mm.getBackingStore().getBatchCount() << std::endl;
+    std::cout << "Coalesced      : " << mm.getBackingStore().getCoalescedWriteCount() << std::endl;
+    std::cout << "Queue Hits     : " << mm.getBackingStore().getQueueHitCount() << std::endl;
+    std::cout << "Read Batches   : " << mm.getBackingStore().getReadBatchCount() << " (" << mm.getBackingStore().getCoalescedReadCount() << " coalesced)" << std::endl;
+    const CompressedPool& pool = mm.getCompressedPool();
+    if (pool.isEnabled()) {
+        std::cout << "Compressed Pool: " << pool.getStoredPageCount() << " pages in " << pool.getUsedBytes()
+                  << " / " << pool.getCapacityBytes() << " bytes" << std::endl;
+        std::cout << "Pool Hits      : " << pool.getHitCount() << " (" << pool.getStoreCount() << " stored, "
+                  << pool.getSpillCount() << " spilled, " << pool.getRejectCount() << " incompressible)" << std::endl;
+    }
+    std::cout << "Blocked Faults : " << snapshot.blockedFaults << std::endl;
+    std::cout << "Pending Faults : " << snapshot.pendingFaults << std::endl;
+
+    // TLB reach is the memory one core can touch without walking a page table
+    long long tlbLookups = snapshot.tlbHits + snapshot.tlbMisses;
+    double tlbHitRate = tlbLookups == 0 ? 0 : (double)snapshot.tlbHits / tlbLookups * 100;
+    std::cout << "\nTLB:" << std::endl;
+    std::cout << "Entries/Core   : " << snapshot.tlbEntries << " (reach " << snapshot.tlbEntries * frameSize << " bytes)" << std::endl;
+    std::cout << "Hits           : " << snapshot.tlbHits << " (" << std::fixed << std::setprecision(1) << tlbHitRate << "%)" << std::endl;
+    if (snapshot.hugePageSize > 0) {
+        std::cout << "Huge Hits      : " << snapshot.tlbHugeHits << " (reach up to " << snapshot.tlbEntries * snapshot.hugePageSize << " bytes)" << std::endl;
+    }
+    std::cout << "Misses         : " << snapshot.tlbMisses << std::endl;
+    std::cout << "Shootdowns     : " << snapshot.tlbShootdowns << std::endl;
+    std::cout << "Flushes        : " << snapshot.tlbFlushes << std::endl;
+
+    std::cout << "\nLoad Control:" << std::endl;
+    std::cout << "Working Sets   : " << scheduler->getWorkingSetTotal() << " / " << totalPages << " pages" << std::endl;
+    std::cout << "Suspensions    : " << scheduler->getSuspensionCount() << std::endl;
+    std::cout << "Resumes        : " << scheduler->getResumeCount() << std::endl;
+    std::cout << "Swapped Out    : " << snapshot.swappedOut << " pages" << std::endl;
+    std::cout << "Locality Picks : " << scheduler->getLocalityPickCount() << " (dispatched out of queue order)" << std::endl;
+
+    std::cout << "\nSwapping:" << std::endl;
+    std::cout << "Swap Outs      : " << scheduler->getSwapOutCount() << " processes ("
+              << mm.getBackingStore().getBatchWriteCount() << " batched writes)" << std::endl;
+    std::cout << "Swap Ins       : " << scheduler->getSwapInCount() << " processes (" << snapshot.swappedIn << " pages)" << std::endl;
 
     std::cout << "\nProcesses by status:" << std::endl;
     std::cout << "Running : " << scheduler->getProcessesByStatus(ProcessStatus::Running).size() << std::endl;
     std::cout << "Waiting : " << scheduler->getProcessesByStatus(ProcessStatus::Waiting).size() << std::endl;
     std::cout << "Sleeping: " << scheduler->getProcessesByStatus(ProcessStatus::Sleeping).size() << std::endl;
+    std::cout << "Faulting: " << scheduler->getProcessesByStatus(ProcessStatus::PageFaultWait).size() << std::endl;
+    std::cout << "Suspended: " << scheduler->getProcessesByStatus(ProcessStatus::Suspended).size() << std::endl;
     std::cout << "Finished: " << scheduler->getProcessesByStatus(ProcessStatus::Finished).size() << std::endl;
 
     std::cout << "===================" << std::endl;
@@ -467,23 +607,10 @@ void MainConsole::showProcessSMI() {
         return;
     }
 
-    std::map<String, int> usedPagesPerProcess;
-    int totalUsedPages = 0;
-
-    for (const String& name : scheduler->getAllProcessNames()) {
-        auto proc = scheduler->getProcess(name);
-        if (!proc) continue;
-
-        int usedPages = 0;
-        for (const auto& [pageNum, entry] : proc->getPageTable()) {
-            if (entry.valid) usedPages++;
-        }
-
-        if (usedPages > 0) {
-            usedPagesPerProcess[name] = usedPages;
-            totalUsedPages += usedPages;
-        }
-    }
+    // Resident pages come from a frame-table snapshot rather than walking live page tables
+    MemorySnapshot snapshot = scheduler->getMemoryManager().captureSnapshot();
+    const std::map<String, int>& usedPagesPerProcess = snapshot.residentPages;
+    int totalUsedPages = snapshot.usedFrames;
 
     int totalMem = Config::getMaxOverallMem();
     int frameSize = Config::getMemPerFrame();
@@ -505,6 +632,10 @@ void MainConsole::showProcessSMI() {
     std::cout << "CPU-Util: " << std::fixed << std::setprecision(0) << cpuUtil << "%" << std::endl;
     std::cout << "Memory Usage: " << usedMem << "MiB / " << totalMem << "MiB" << std::endl;
     std::cout << "Memory Util: " << std::fixed << std::setprecision(0) << memUtil << "%" << std::endl;
+    long long tlbLookups = snapshot.tlbHits + snapshot.tlbMisses;
+    float tlbHitRate = (tlbLookups == 0) ? 0 : ((float)snapshot.tlbHits / tlbLookups) * 100;
+    std::cout << "TLB Hit Rate: " << std::fixed << std::setprecision(0) << tlbHitRate << "% ("
+              << snapshot.tlbMisses << " misses, " << snapshot.tlbShootdowns << " shootdowns)" << std::endl;
     std::cout << std::endl;
     std::cout << "Running processes and memory usage:" << std::endl;
     
@@ -530,9 +661,13 @@ void MainConsole::createProcess(const String& processName, int memorySize) {
 
     int minIns = Config::getMinIns();
     int maxIns = Config::getMaxIns();
-    int numInstructions = minIns + (rand() % (maxIns - minIns + 1));
+    // The length comes from the program seed, so processes of the same size can share a variant's image
+    int programSeed = ProgramCache::pickSeed();
+    std::mt19937 shapeGen(static_cast<uint32_t>(programSeed));
+    int numInstructions = std::uniform_int_distribution<>(minIns, maxIns)(shapeGen);
 
-    auto newProcess = std::make_shared<Process>(processName, scheduler->getNextProcessId(), numInstructions, memorySize);
+    auto newProcess = std::make_shared<Process>(processName, scheduler->getNextProcessId(), numInstructions,
+        memorySize, "", programSeed);
     scheduler->addProcess(newProcess);
 
     std::cout << "\033[32mProcess " << processName << " created successfully!\033[0m\n";
@@ -560,6 +695,8 @@ void MainConsole::listProcesses() {
     auto runningProcesses = scheduler->getProcessesByStatus(ProcessStatus::Running);
     auto waitingProcesses = scheduler->getProcessesByStatus(ProcessStatus::Waiting);
     auto sleepingProcesses = scheduler->getProcessesByStatus(ProcessStatus::Sleeping);
+    auto faultingProcesses = scheduler->getProcessesByStatus(ProcessStatus::PageFaultWait);
+    auto suspendedProcesses = scheduler->getProcessesByStatus(ProcessStatus::Suspended);
     auto finishedProcesses = scheduler->getProcessesByStatus(ProcessStatus::Finished);
     
     std::cout << "\nRunning processes:" << std::endl;
@@ -592,6 +729,26 @@ void MainConsole::listProcesses() {
                      << currentLine << " / " << process->getTotalInstructions() << " (sleeping)" << std::endl;
         }
     }
+
+    // Processes blocked on a page fault are waiting on the pager rather than a core
+    for (const String& processName : faultingProcesses) {
+        auto process = scheduler->getProcess(processName);
+        if (process) {
+            int currentLine = process->getTotalInstructions() - process->getRemainingInstructions();
+            std::cout << processName << "\t(" << process->getCreationTime() << ")\t"
+                     << currentLine << " / " << process->getTotalInstructions() << " (page fault)" << std::endl;
+        }
+    }
+
+    // Processes swapped out by load control until memory frees up
+    for (const String& processName : suspendedProcesses) {
+        auto process = scheduler->getProcess(processName);
+        if (process) {
+            int currentLine = process->getTotalInstructions() - process->getRemainingInstructions();
+            std::cout << processName << "\t(" << process->getCreationTime() << ")\t"
+                     << currentLine << " / " << process->getTotalInstructions() << " (suspended)" << std::endl;
+        }
+    }
     
     std::cout << "\nFinished processes:" << std::endl;
     for (const String& processName : finishedProcesses) {
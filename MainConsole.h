@@ -24,7 +24,6 @@ private:
     // Scheduler system (now handles all process management)
     std::unique_ptr<CPUScheduler> scheduler;
     std::shared_ptr<MemoryManager> memoryManager;
-    std::shared_ptr<CoreManager> coreManager;
     int nextProcessId;
 
     // Command handling
@@ -7,131 +7,1029 @@
 #include <algorithm>
 #include <iomanip>
 #include <ctime>
+#include <cstring>
 
-MemoryManager::MemoryManager() {
-    totalMemorySize = Config::getMaxOverallMem();
-    frameSize = Config::getMemPerFrame();
-    processMemorySize = Config::getMemPerProc();
+MemorySettings MemorySettings::fromConfig() {
+    MemorySettings settings;
+    settings.policyName = Config::getPageReplacement();
+    settings.allocatorName = Config::getMemoryAllocator();
+    settings.pagerQueueSize = Config::getPagerQueueSize();
+    settings.compressedPoolSize = Config::getCompressedPoolSize();
+    settings.pageFaultLatency = Config::getPageFaultLatency();
+    settings.readaheadWindow = Config::getReadaheadWindow();
+    settings.hugePageSize = Config::getHugePageSize();
+    settings.hugePageThreshold = Config::getHugePageThreshold();
+    settings.tlbEntries = Config::getTlbEntries();
+    settings.tlbCount = Config::getNumCpu();
+    settings.mergeScanPages = Config::getMergeScanPages();
+    settings.processMemorySize = Config::getMemPerProc();
+    return settings;
+}
+
+MemoryManager::MemoryManager()
+    : MemoryManager(Config::getMaxOverallMem(), Config::getMemPerFrame(), "csopesy-backing-store-data.bin") {
+    std::cout << "Memory Manager initialized:" << std::endl;
+    std::cout << "  Total memory: " << totalMemorySize << " bytes" << std::endl;
+    std::cout << "  Frame size: " << frameSize << " bytes" << std::endl;
+    std::cout << "  Process memory size: " << processMemorySize << " bytes" << std::endl;
+    std::cout << "  Replacement policy: " << replacementPolicy->getName() << std::endl;
+    std::cout << "  Memory allocator: " << getAllocatorName() << std::endl;
+}
+
+MemoryManager::MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile)
+    : MemoryManager(totalMemory, frameBytes, backingStoreFile, Config::getPageReplacement()) {
+}
+
+MemoryManager::MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile, const String& policyName)
+    : MemoryManager(totalMemory, frameBytes, backingStoreFile, policyName, Config::getMemoryAllocator()) {
+}
+
+MemoryManager::MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile, const String& policyName,
+    const String& allocatorName)
+    : MemoryManager(totalMemory, frameBytes, backingStoreFile, [&]() {
+        MemorySettings settings = MemorySettings::fromConfig();
+        settings.policyName = policyName;
+        settings.allocatorName = allocatorName;
+        return settings;
+    }()) {
+}
+
+MemoryManager::MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile, const MemorySettings& settings)
+    : totalMemorySize(totalMemory), frameSize(frameBytes), backingStore(backingStoreFile, frameBytes, settings.pagerQueueSize),
+      compressedPool(backingStore, frameBytes, settings.compressedPoolSize),
+      pageFaultLatency(settings.pageFaultLatency) {
+    const String& allocatorName = settings.allocatorName;
+    processMemorySize = settings.processMemorySize;
     numFrames = totalMemorySize / frameSize;
+    readaheadLimit = std::min(settings.readaheadWindow, numFrames / 4); // Never let readahead crowd out the working set
+    replacementPolicy = ReplacementPolicy::create(settings.policyName, numFrames);
 
-    freeFrameList.resize(numFrames, true);
-    frameTable.resize(numFrames, { "", -1, false, false });
+    // A huge page must be a power-of-two number of frames, or huge pages stay off
+    hugePageFrames = settings.hugePageSize / frameSize;
+    hugePageThreshold = settings.hugePageThreshold;
+    if (settings.hugePageSize > 0 && (settings.hugePageSize % frameSize != 0 || hugePageFrames < 2 ||
+        (hugePageFrames & (hugePageFrames - 1)) != 0 || hugePageFrames > numFrames)) {
+        std::cout << "Warning: huge-page-size must be a power-of-two multiple of mem-per-frame. Huge pages disabled." << std::endl;
+        hugePageFrames = 1;
+    }
+    hugePageFrames = std::max(hugePageFrames, 1);
 
-    for (int i = 0; i < numFrames; ++i) {
-        freeFrames.push(i);
+    for (int core = 0; core < settings.tlbCount; ++core) {
+        tlbs.push_back(std::make_unique<TLB>(settings.tlbEntries, hugePageFrames));
     }
 
-    memoryBlocks.push_back(MemoryBlock(0, totalMemorySize, "", false));
+    freeFrames.reset(numFrames);
+    mergeScanBudget = settings.mergeScanPages;
+    frameChecksums.assign(numFrames, 0);
+    physicalMemory.resize(static_cast<size_t>(numFrames) * frameSize, 0);
+    frameTable.assign(numFrames, FrameInfo{});
 
-    std::cout << "Memory Manager initialized:" << std::endl;
-    std::cout << "  Total memory: " << totalMemorySize << " bytes" << std::endl;
-    std::cout << "  Frame size: " << frameSize << " bytes" << std::endl;
-    std::cout << "  Process memory size: " << processMemorySize << " bytes" << std::endl;
+    useBuddyAllocator = allocatorName == "buddy";
+    if (!useBuddyAllocator && allocatorName != "firstfit") {
+        std::cout << "Warning: Unknown memory-allocator '" << allocatorName << "'. Using firstfit." << std::endl;
+    }
+    if (useBuddyAllocator) {
+        buddyAllocator.reset(totalMemorySize);
+    }
+    else {
+        memoryBlocks.push_back(MemoryBlock(0, totalMemorySize, "", false));
+    }
 }
 
-void MemoryManager::setProcessMap(const std::unordered_map<String, std::shared_ptr<Process>>& map) {
-    allProcesses = map;
+void MemoryManager::registerProcess(const std::shared_ptr<Process>& process) {
+    std::lock_guard<std::mutex> lock(allocationMutex);
+    allProcesses[process->getName()] = process;
+}
+
+int MemoryManager::claimFrame(Process* proc, int pageNumber, bool prefetch, const uint8_t* pageData, bool dirty) {
+    // Try free frame first, otherwise evict the policy's victim and reuse its frame.
+    // A prefetch is only a guess, so it takes a free frame or nothing.
+    int frameNumber = freeFrames.allocate();
+    bool evict = frameNumber < 0;
+    if (evict && prefetch) {
+        return -1;
+    }
+
+    uint64_t pageKey = ReplacementPolicy::makePageKey(proc->getId(), pageNumber);
+    replacementPolicy->onFault(pageKey);
+    if (evict) {
+        frameNumber = replacementPolicy->selectVictim(frameTable);
+    }
+
+    installPage(frameNumber, evict, proc, pageNumber, prefetch, pageData, dirty, -1);
+    replacementPolicy->onMap(frameNumber, pageKey);
+    return frameNumber;
+}
+
+void MemoryManager::installPage(int frameNumber, bool evict, Process* proc, int pageNumber, bool prefetch,
+    const uint8_t* pageData, bool dirty, int hugeBase) {
+    std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+    if (evict) {
+        evictFrame(frameNumber);
+    }
+
+    // Prefetched pages start unreferenced so an unused readahead is the first thing clock reclaims
+    FrameInfo& frame = resetFrame(frameNumber);
+    frame.processName = proc->getName();
+    frame.pageNumber = pageNumber;
+    frame.isOccupied = true;
+    frame.referenced = !prefetch;
+    frame.owner = proc;
+    frame.prefetched = prefetch;
+    frame.hugeBase = hugeBase;
+    std::memcpy(&physicalMemory[static_cast<size_t>(frameNumber) * frameSize], pageData, frameSize);
+
+    PageTableEntry& entry = proc->getPageTableRef().entryFor(pageNumber);
+    entry.frameNumber = frameNumber;
+    entry.dirty = dirty;
+    entry.huge = hugeBase >= 0;
+    if (!prefetch) {
+        entry.lastUseTick = currentTick.load();  // The fault itself is a reference
+    }
+    entry.cow = false;
+    entry.valid = true;
 }
 
 int MemoryManager::allocatePage(Process* proc, int pageNumber) {
+    if (usesHugePage(proc, pageNumber)) {
+        return allocateHugePage(proc, pageNumber);
+    }
+
+    bool codePage = isCodePage(proc, pageNumber);
+    if (codePage) {
+        std::lock_guard<std::mutex> mapLock(mapMutex);
+        int sharedFrame = mapSharedCode(proc, pageNumber);
+        if (sharedFrame >= 0) {
+            return sharedFrame;
+        }
+    }
+
+    // Read the page image before taking the map lock so faults on different cores overlap their I/O.
+    // Pool pages are decoded under the lock instead, so a concurrent reader always finds the page somewhere.
+    std::vector<uint8_t> pageData(frameSize);
+    bool inPool = compressedPool.contains(proc->getId(), pageNumber);
+    bool onFile = !inPool && backingStore.readPage(proc->getId(), pageNumber, pageData.data());
+
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    bool fromPool = !onFile && compressedPool.load(proc->getId(), pageNumber, pageData.data());
+    if (!onFile && !fromPool) {
+        // The pool may have spilled the page to the file since we looked; otherwise it starts zero-filled
+        if (!backingStore.readPage(proc->getId(), pageNumber, pageData.data())) {
+            std::fill(pageData.begin(), pageData.end(), static_cast<uint8_t>(0));
+        }
+    }
+
+    // A pool hit gave up the only copy, so the page must be written out again if evicted
+    int frameNumber = claimFrame(proc, pageNumber, false, pageData.data(), fromPool);
+    if (codePage) {
+        publishCode(frameNumber, proc, pageNumber);
+    }
+    faultCount++;
+    pagedInCount++;
+    return frameNumber;
+}
+
+bool MemoryManager::tryMapSharedCode(Process* proc, int pageNumber) {
+    if (!isCodePage(proc, pageNumber)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    return mapSharedCode(proc, pageNumber) >= 0;
+}
+
+bool MemoryManager::isCodePage(Process* proc, int pageNumber) const {
+    return pageNumber >= proc->getCodeSegmentStart();
+}
+
+std::tuple<const ProgramImage*, int, int> MemoryManager::codeKey(Process* proc, int pageNumber) const {
+    return { &proc->getProgram(), proc->getCodeSegmentStart(), pageNumber };
+}
+
+int MemoryManager::mapSharedCode(Process* proc, int pageNumber) {
+    auto it = codeFrames.find(codeKey(proc, pageNumber));
+    if (it == codeFrames.end()) {
+        return -1;
+    }
+
+    int frameNumber = it->second;
+    std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+    FrameInfo& frame = frameTable[frameNumber];
+    frame.sharers.push_back({ proc, pageNumber });
+    frame.referenced = true;
+    frame.prefetched = false;
+
+    // Read-only and never dirty: an eviction just drops this mapping, and a later fault maps or reads it again
+    PageTableEntry& entry = proc->getPageTableRef().entryFor(pageNumber);
+    entry.frameNumber = frameNumber;
+    entry.dirty = false;
+    entry.huge = false;
+    entry.lastUseTick = currentTick.load();
+    entry.cow = false;
+    entry.valid = true;
+    sharedCodeMapCount++;
+    return frameNumber;
+}
+
+void MemoryManager::publishCode(int frameNumber, Process* proc, int pageNumber) {
+    // Two processes can fault the same code page at once; the first copy published is the one shared
+    if (codeFrames.emplace(codeKey(proc, pageNumber), frameNumber).second) {
+        std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+        frameTable[frameNumber].sharedCode = true;
+    }
+}
+
+int MemoryManager::readaheadCode(Process* proc, int faultPage) {
+    // Readahead only shortens PageFaultWait; with faults resolved inline there is no wait to save
+    if (readaheadLimit <= 0 || !usesBlockingFaults()) {
+        return 0;
+    }
+
     auto& pageTable = proc->getPageTableRef();
+    std::lock_guard<std::mutex> mapLock(mapMutex);
 
-    // Try free frame first
-    for (int i = 0; i < numFrames; ++i) {
-        if (freeFrameList[i]) {
-            freeFrameList[i] = false;
-            frameTable[i] = { proc->getName(), pageNumber, true, true }; // referenced = true
-            pageTable[pageNumber] = { i, true, false };
-            pagedInCount++;
-
-            // TOBEDELETED: MO2 backing store - try to load page data from backing store
-            std::unordered_map<uint32_t, uint16_t> pageData;
-            if (loadPageFromBackingStore(proc->getName(), pageNumber, pageData)) {
-                // TOBEDELETED: Restore page data from backing store
-                for (const auto& [address, value] : pageData) {
-                    proc->setMemoryValueAt(address, value);
-                }
+    // A fault right where the last window ended means the stream is sequential: grow the window.
+    // Anything else (a FOR back-edge, or a prefetched page evicted before use) is a miss: shrink it.
+    ReadaheadState& ra = proc->getReadaheadState();
+    if (faultPage == ra.nextExpectedPage) {
+        ra.window = std::min(std::max(ra.window * 2, 1), readaheadLimit);
+    }
+    else {
+        ra.window /= 2;
+    }
+
+    int lastPage = std::min(faultPage + ra.window, proc->getLastCodePage());
+    ra.nextExpectedPage = lastPage + 1;
+
+    // Instructions live in the ProgramImage, so code pages have no backing copy and start zero-filled;
+    // there is nothing to read. Pages another process already has resident are mapped instead, and
+    // the rest only take free frames, so the window never pushes out resident data.
+    std::vector<uint8_t> zeroPage(frameSize, 0);
+    int mapped = 0;
+    for (int page = faultPage + 1; page <= lastPage; ++page) {
+        if (pageTable.isResident(page) || mapSharedCode(proc, page) >= 0) {
+            continue;
+        }
+        int frameNumber = claimFrame(proc, page, true, zeroPage.data(), false);
+        if (frameNumber < 0) {
+            break;
+        }
+        publishCode(frameNumber, proc, page);
+        mapped++;
+    }
+    readaheadPageCount += mapped;
+    pagedInCount += mapped;
+    return mapped;
+}
+
+void MemoryManager::readPageImages(Process* proc, const std::vector<int>& pages, std::vector<uint8_t>& buffer,
+    std::vector<bool>& onFile) {
+    // One batched backing-store read for the pages not held compressed in RAM, outside the map lock
+    buffer.assign(pages.size() * static_cast<size_t>(frameSize), 0);
+    onFile.assign(pages.size(), false);
+    std::vector<int> filePages;
+    std::vector<uint8_t*> fileData;
+    std::vector<size_t> fileIndex;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (!compressedPool.contains(proc->getId(), pages[i])) {
+            filePages.push_back(pages[i]);
+            fileData.push_back(&buffer[i * frameSize]);
+            fileIndex.push_back(i);
+        }
+    }
+    if (filePages.empty()) {
+        return;
+    }
+
+    std::vector<bool> found;
+    backingStore.readPages(proc->getId(), filePages, fileData, found);
+    for (size_t f = 0; f < filePages.size(); ++f) {
+        onFile[fileIndex[f]] = found[f];
+    }
+}
+
+bool MemoryManager::finishPageImage(Process* proc, int pageNumber, uint8_t* pageData, bool onFile) {
+    if (onFile) {
+        return false;
+    }
+    if (compressedPool.load(proc->getId(), pageNumber, pageData)) {
+        return true;
+    }
+    if (!backingStore.readPage(proc->getId(), pageNumber, pageData)) {
+        std::memset(pageData, 0, frameSize);  // Never written (a page spilled from the pool after the batch read is found here)
+    }
+    return false;
+}
+
+bool MemoryManager::usesHugePage(Process* proc, int pageNumber) const {
+    if (hugePageFrames <= 1 || proc->getMemorySize() < hugePageThreshold) {
+        return false;
+    }
+
+    // Only whole huge pages inside the data segment; code pages keep their readahead
+    int basePage = pageNumber - pageNumber % hugePageFrames;
+    return static_cast<long long>(basePage + hugePageFrames) * frameSize <= proc->getMemorySize();
+}
+
+int MemoryManager::allocateHugePage(Process* proc, int pageNumber) {
+    int basePage = pageNumber - pageNumber % hugePageFrames;
+
+    // Pages of a split huge page stay base pages; collapsing them back is not attempted
+    const PageTable& pageTable = proc->getPageTable();
+    bool splitRun = false;
+    for (int page = basePage; page < basePage + hugePageFrames && !splitRun; ++page) {
+        splitRun = pageTable.isResident(page);
+    }
+
+    // Huge pages only come from free, aligned runs, so under memory pressure this is a base-page fault.
+    // The free count is only a hint; don't read a whole run in when it can't possibly be mapped.
+    bool tryHuge = !splitRun && freeFrames.getFreeCount() >= hugePageFrames;
+    std::vector<int> pages(1, pageNumber);
+    if (tryHuge) {
+        pages.clear();
+        for (int page = basePage; page < basePage + hugePageFrames; ++page) {
+            pages.push_back(page);
+        }
+    }
+
+    std::vector<uint8_t> buffer;
+    std::vector<bool> onFile;
+    readPageImages(proc, pages, buffer, onFile);
+
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    int firstFrame = tryHuge ? freeFrames.allocateRun(hugePageFrames) : -1;
+    faultCount++;
+    if (firstFrame < 0) {
+        size_t index = tryHuge ? pageNumber - basePage : 0;
+        uint8_t* data = &buffer[index * frameSize];
+        bool fromPool = finishPageImage(proc, pageNumber, data, onFile[index]);
+        if (!splitRun) {
+            hugeFallbackCount++;
+        }
+        pagedInCount++;
+        return claimFrame(proc, pageNumber, false, data, fromPool);
+    }
+
+    for (int i = 0; i < hugePageFrames; ++i) {
+        uint8_t* data = &buffer[static_cast<size_t>(i) * frameSize];
+        bool fromPool = finishPageImage(proc, pages[i], data, onFile[i]);
+        uint64_t pageKey = ReplacementPolicy::makePageKey(proc->getId(), pages[i]);
+        replacementPolicy->onFault(pageKey);
+        installPage(firstFrame + i, false, proc, pages[i], false, data, fromPool, firstFrame);
+        replacementPolicy->onMap(firstFrame + i, pageKey);
+    }
+    hugePageCount++;
+    pagedInCount += hugePageFrames;
+    return firstFrame + (pageNumber - basePage);
+}
+
+void MemoryManager::splitHugePage(int firstFrame) {
+    // Each frame keeps its page; the pages just stop being one mapping
+    for (int frameNumber = firstFrame; frameNumber < firstFrame + hugePageFrames; ++frameNumber) {
+        FrameInfo& frame = frameTable[frameNumber];
+        frame.hugeBase = -1;
+        if (PageTableEntry* entry = frame.owner ? frame.owner->getPageTableRef().find(frame.pageNumber) : nullptr) {
+            entry->huge = false;
+        }
+    }
+    hugeSplitCount++;
+}
+
+void MemoryManager::queuePageFault(Process* proc, const std::vector<int>& pages, int codePage) {
+    std::lock_guard<std::mutex> lock(faultQueueMutex);
+
+    // The pager services one fault at a time, so a request starts once the ones ahead of it are done
+    long long startTick = std::max(currentTick.load() + 1, pagerBusyUntil);
+    long long readyTick = startTick + pageFaultLatency;
+    pagerBusyUntil = readyTick;
+
+    faultQueue.push_back({ proc, pages, codePage, readyTick });
+    blockedFaultCount++;
+}
+
+std::vector<Process*> MemoryManager::servicePageFaults(long long tick) {
+    currentTick = tick;
+
+    std::vector<PageFaultRequest> ready;
+    {
+        std::lock_guard<std::mutex> lock(faultQueueMutex);
+        while (!faultQueue.empty() && faultQueue.front().readyTick <= tick) {
+            ready.push_back(faultQueue.front());
+            faultQueue.pop_front();
+        }
+    }
+
+    // The faulting processes are off their cores, so their page tables are ours to fill
+    std::vector<Process*> resumed;
+    for (const PageFaultRequest& request : ready) {
+        auto& pageTable = request.process->getPageTableRef();
+        for (int pageNumber : request.pages) {
+            if (!pageTable.isResident(pageNumber)) {
+                allocatePage(request.process, pageNumber);
+            }
+        }
+        if (request.codePage >= 0) {
+            readaheadCode(request.process, request.codePage);
+        }
+        resumed.push_back(request.process);
+    }
+    return resumed;
+}
+
+int MemoryManager::getPendingFaultCount() const {
+    std::lock_guard<std::mutex> lock(faultQueueMutex);
+    return static_cast<int>(faultQueue.size());
+}
+
+void MemoryManager::evictFrame(int frameNumber, bool writeBack) {
+    FrameInfo& frame = frameTable[frameNumber];
+
+    // Evicting part of a huge page splits it into base pages first
+    if (frame.hugeBase >= 0) {
+        splitHugePage(frame.hugeBase);
+    }
+
+    if (frame.sharedCode) {
+        auto it = codeFrames.find(codeKey(frame.owner, frame.pageNumber));
+        if (it != codeFrames.end() && it->second == frameNumber) {
+            codeFrames.erase(it);
+        }
+    }
+
+    // Invalidate the victim through the reverse map instead of scanning every page table
+    unmapPage(frameNumber, frame.owner, frame.pageNumber, writeBack);
+    for (const FrameMapping& sharer : frame.sharers) {
+        unmapPage(frameNumber, sharer.process, sharer.pageNumber, writeBack);
+    }
+
+    // Readahead that was never used means the window outran this process's memory
+    if (frame.prefetched) {
+        ReadaheadState& ra = frame.owner->getReadaheadState();
+        ra.window /= 2;
+        readaheadWasteCount++;
+    }
+
+    replacementPolicy->onUnmap(frameNumber);
+    pagedOutCount++;
+    resetFrame(frameNumber);
+}
+
+FrameInfo& MemoryManager::resetFrame(int frameNumber) {
+    FrameInfo& frame = frameTable[frameNumber];
+    frame = FrameInfo{};
+    return frame;
+}
+
+void MemoryManager::unmapPage(int frameNumber, Process* mapper, int pageNumber, bool writeBack) {
+    const uint8_t* frameData = &physicalMemory[static_cast<size_t>(frameNumber) * frameSize];
+    int mapperId = mapper->getId();
+
+    PageTableEntry* entry = mapper->getPageTableRef().find(pageNumber);
+    bool dirty = true;
+    if (entry && entry->frameNumber == frameNumber) {
+        dirty = entry->dirty;
+        entry->valid = false;
+        entry->dirty = false;
+        entry->cow = false;  // Each process pages its own copy back in
+    }
+
+    // Clean pages already match their backing copy (or are still all zero) and are simply dropped.
+    // Dirty pages are written back, except all-zero ones, which page in zero-filled with no slot.
+    if (dirty && writeBack) {
+        if (isZeroPage(frameData)) {
+            compressedPool.discard(mapperId, pageNumber);
+            backingStore.discardPage(mapperId, pageNumber);
+            zeroPageDropCount++;
+        }
+        else if (compressedPool.store(mapperId, pageNumber, frameData)) {
+            backingStore.discardPage(mapperId, pageNumber);  // The pool copy supersedes any file copy
+            poolStoreCount++;
+        }
+        else {
+            backingStore.writePage(mapperId, pageNumber, frameData);
+            writebackCount++;
+        }
+    }
+    else if (writeBack) {
+        cleanDiscardCount++;
+    }
+
+    // Shoot down the stale translation on every core that cached it
+    for (auto& tlb : tlbs) {
+        tlb->shootdown(mapperId, pageNumber);
+    }
+}
+
+void MemoryManager::detachMapping(int frameNumber, Process* proc, int pageNumber, bool writeBack) {
+    FrameInfo& frame = frameTable[frameNumber];
+    if (frame.hugeBase >= 0) {
+        splitHugePage(frame.hugeBase);  // The run is no longer one process's contiguous mapping
+    }
+    unmapPage(frameNumber, proc, pageNumber, writeBack);
+
+    if (frame.owner == proc && frame.pageNumber == pageNumber) {
+        frame.owner = frame.sharers.back().process;
+        frame.pageNumber = frame.sharers.back().pageNumber;
+        frame.processName = frame.owner->getName();
+        frame.sharers.pop_back();
+    }
+    else {
+        frame.sharers.erase(std::find(frame.sharers.begin(), frame.sharers.end(), FrameMapping{ proc, pageNumber }));
+    }
+
+    // The last process still mapping the frame has it to itself, so its writes need no copy and
+    // the frame no longer counts as merged
+    if (frame.sharers.empty()) {
+        if (PageTableEntry* entry = frame.owner->getPageTableRef().find(frame.pageNumber)) {
+            entry->cow = false;
+        }
+        frame.merged = false;
+    }
+}
+
+bool MemoryManager::isZeroPage(const uint8_t* pageData) const {
+    return std::all_of(pageData, pageData + frameSize, [](uint8_t byte) { return byte == 0; });
+}
+
+uint16_t MemoryManager::readPhysicalWord(int frameNumber, int offset) const {
+    std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+    uint16_t value;
+    std::memcpy(&value, &physicalMemory[static_cast<size_t>(frameNumber) * frameSize + offset], sizeof(value));
+    return value;
+}
+
+void MemoryManager::writePhysicalWord(int frameNumber, int offset, uint16_t value) {
+    std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+    std::memcpy(&physicalMemory[static_cast<size_t>(frameNumber) * frameSize + offset], &value, sizeof(value));
+}
+
+bool MemoryManager::readMappedWord(Process* proc, int pageNumber, int frameNumber, int offset, uint16_t& value) {
+    {
+        std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+        FrameInfo& frame = frameTable[frameNumber];
+        if (!frame.maps(proc, pageNumber)) {
+            invalidateStaleTlb(proc, pageNumber);
+            return false;
+        }
+        frame.referenced = true;
+        frame.prefetched = false;
+        proc->getPageTableRef().find(pageNumber)->lastUseTick = currentTick.load();
+        std::memcpy(&value, &physicalMemory[static_cast<size_t>(frameNumber) * frameSize + offset], sizeof(value));
+    }
+    noteAccess(frameNumber);
+    return true;
+}
+
+bool MemoryManager::writeMappedWord(Process* proc, int pageNumber, int frameNumber, int offset, uint16_t value) {
+    bool copyOnWrite;
+    {
+        std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+        FrameInfo& frame = frameTable[frameNumber];
+        if (!frame.maps(proc, pageNumber)) {
+            invalidateStaleTlb(proc, pageNumber);
+            return false;
+        }
+        frame.referenced = true;
+        frame.prefetched = false;
+        PageTableEntry& entry = *proc->getPageTableRef().find(pageNumber);
+        entry.lastUseTick = currentTick.load();
+        copyOnWrite = entry.cow;
+        if (!copyOnWrite) {
+            entry.dirty = true;
+            std::memcpy(&physicalMemory[static_cast<size_t>(frameNumber) * frameSize + offset], &value, sizeof(value));
+        }
+    }
+
+    // A write to a shared frame takes a private copy first; the caller then retranslates and writes the copy
+    if (copyOnWrite) {
+        breakCopyOnWrite(proc, pageNumber);
+        return false;
+    }
+    noteAccess(frameNumber);
+    return true;
+}
+
+int MemoryManager::lookupTlb(int coreId, int processId, int pageNumber) {
+    if (coreId < 0 || coreId >= static_cast<int>(tlbs.size())) {
+        return -1;
+    }
+    return tlbs[coreId]->lookup(processId, pageNumber);
+}
+
+void MemoryManager::fillTlb(int coreId, int processId, int pageNumber, int frameNumber, bool huge) {
+    if (coreId >= 0 && coreId < static_cast<int>(tlbs.size())) {
+        tlbs[coreId]->insert(processId, pageNumber, frameNumber, huge);
+    }
+}
+
+void MemoryManager::switchTlbContext(int coreId, int processId) {
+    if (coreId >= 0 && coreId < static_cast<int>(tlbs.size())) {
+        tlbs[coreId]->switchTo(processId);
+    }
+}
+
+void MemoryManager::invalidateStaleTlb(Process* proc, int pageNumber) {
+    int coreId = proc->getAssignedCore();
+    if (coreId >= 0 && coreId < static_cast<int>(tlbs.size())) {
+        tlbs[coreId]->invalidate(proc->getId(), pageNumber);
+    }
+}
+
+// Copies a page image without faulting it in: from its frame if resident, else from the backing store
+bool MemoryManager::readPageContents(Process* proc, int pageNumber, uint8_t* pageData) {
+    {
+        std::lock_guard<std::mutex> mapLock(mapMutex);
+        const PageTableEntry* entry = proc->getPageTable().find(pageNumber);
+        if (entry && entry->valid) {
+            int frameNumber = entry->frameNumber;
+            std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+            std::memcpy(pageData, &physicalMemory[static_cast<size_t>(frameNumber) * frameSize], frameSize);
+            return true;
+        }
+        if (compressedPool.peek(proc->getId(), pageNumber, pageData)) {
+            return true;
+        }
+    }
+    return backingStore.readPage(proc->getId(), pageNumber, pageData);
+}
+
+void MemoryManager::markPageAccessed(int frameNumber, Process* proc, int pageNumber) {
+    if (frameNumber < 0 || frameNumber >= static_cast<int>(frameTable.size())) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+        FrameInfo& frame = frameTable[frameNumber];
+        frame.referenced = true;
+        frame.prefetched = false;
+
+        // Stamp the reference so working sets can be measured over a tick window
+        bool mapped = proc && frame.maps(proc, pageNumber);
+        Process* mapper = mapped ? proc : frame.owner;
+        if (mapper) {
+            PageTableEntry* entry = mapper->getPageTableRef().find(mapped ? pageNumber : frame.pageNumber);
+            if (entry) {
+                entry->lastUseTick = currentTick.load();
             }
+        }
+    }
+    noteAccess(frameNumber);
+}
 
-            return i;
-        }
-    }
-
-    // CLOCK ALGORITHM: Find a victim frame to evict
-    while (true) {
-        FrameInfo& frame = frameTable[clockHand];
-
-        if (!frame.referenced) {
-            int victimPage = frame.pageNumber;
-            String victimProcessName = frame.processName;
-
-                            auto victimProcess = allProcesses.find(victimProcessName);
-                if (victimProcess != allProcesses.end()) {
-                    auto memoryDump = victimProcess->second->getMemoryDump();
-                    std::unordered_map<uint32_t, uint16_t> pageData;
-                int pageSize = Config::getMemPerFrame();
-                uint32_t pageStartAddress = victimPage * pageSize;
-                uint32_t pageEndAddress = pageStartAddress + pageSize;
-                
-                for (const auto& [address, value] : memoryDump) {
-                    if (address >= pageStartAddress && address < pageEndAddress) {
-                        pageData[address] = value;
-                    }
-                                    }
-                    
-                    if (!pageData.empty()) {
-                        savePageToBackingStore(victimProcessName, victimPage, pageData);
-                    }
-                }
-
-            // Invalidate the victim in its process's page table
-            for (const auto& [name, process] : allProcesses) {
-                auto& pt = process->getPageTableRef();
-                for (auto& entry : pt) {
-                    if (entry.second.frameNumber == clockHand && entry.second.valid) {
-                        entry.second.valid = false;
-                        break;
-                    }
-                }
+void MemoryManager::noteAccess(int frameNumber) {
+    // Clock only reads reference bits, so the common case never touches the map lock
+    if (replacementPolicy->tracksAccesses()) {
+        std::lock_guard<std::mutex> mapLock(mapMutex);
+        replacementPolicy->onAccess(frameNumber);
+    }
+}
+
+int MemoryManager::getWorkingSetSize(Process* proc, int window) const {
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    long long now = currentTick.load();
+    int pages = 0;
+    proc->getPageTable().forEachMapped([&](int, const PageTableEntry& entry) {
+        long long lastUse = entry.lastUseTick;
+        if (lastUse >= 0 && now - lastUse < window) {
+            pages++;
+        }
+    });
+    return pages;
+}
+
+double MemoryManager::getResidentRatio(Process* proc) const {
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    int touched = 0;
+    int resident = 0;
+    proc->getPageTable().forEachMapped([&](int, const PageTableEntry& entry) {
+        touched++;
+        resident += entry.valid ? 1 : 0;
+    });
+    return touched > 0 ? static_cast<double>(resident) / touched : 0.0;
+}
+
+int MemoryManager::swapOutProcess(Process* proc) {
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    int processId = proc->getId();
+    std::vector<int> resident;
+    std::vector<int> batchPages;
+    std::vector<uint8_t> batch;
+    int freed = 0;
+    proc->getPageTableRef().forEachMapped([&](int pageNumber, PageTableEntry& entry) {
+        if (!entry.valid) {
+            return;
+        }
+        int frameNumber = entry.frameNumber;
+        std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+        resident.push_back(pageNumber);
+
+        // A frame still shared with other mappings stays resident for them
+        if (!frameTable[frameNumber].sharers.empty()) {
+            detachMapping(frameNumber, proc, pageNumber, true);
+            return;
+        }
+
+        // Clean pages join the batch too, so the whole image sits on one run of slots for swap-in.
+        // All-zero pages are dropped instead and page back in zero-filled.
+        const uint8_t* frameData = &physicalMemory[static_cast<size_t>(frameNumber) * frameSize];
+        compressedPool.discard(processId, pageNumber);
+        if (isZeroPage(frameData)) {
+            backingStore.discardPage(processId, pageNumber);
+            if (entry.dirty) {
+                zeroPageDropCount++;
+            }
+            else {
+                cleanDiscardCount++;
+            }
+        }
+        else {
+            batchPages.push_back(pageNumber);
+            batch.insert(batch.end(), frameData, frameData + frameSize);
+        }
+        evictFrame(frameNumber, false);
+        freeFrames.release(frameNumber);
+        freed++;
+    });
+
+    backingStore.writePages(processId, batchPages, batch.data());
+    swapOutWriteCount += static_cast<int>(batchPages.size());
+    swappedOutPages[processId] = std::move(resident);
+    swappedOutPageCount += freed;
+    return freed;
+}
+
+int MemoryManager::swapInProcess(Process* proc) {
+    auto& pageTable = proc->getPageTableRef();
+    std::vector<int> pages;
+    {
+        std::lock_guard<std::mutex> mapLock(mapMutex);
+        auto it = swappedOutPages.find(proc->getId());
+        if (it == swappedOutPages.end()) {
+            return 0;
+        }
+
+        // Code pages another process has resident are mapped now and need no read
+        for (int page : it->second) {
+            if (!pageTable.isResident(page) && mapSharedCode(proc, page) < 0) {
+                pages.push_back(page);
+            }
+        }
+        swappedOutPages.erase(it);
+    }
+    if (pages.empty()) {
+        return 0;
+    }
+
+    std::vector<uint8_t> buffer;
+    std::vector<bool> onFile;
+    readPageImages(proc, pages, buffer, onFile);
+
+    // The pages were the process's working set when it left, so they come back referenced
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    for (size_t i = 0; i < pages.size(); ++i) {
+        uint8_t* data = &buffer[i * frameSize];
+        bool fromPool = finishPageImage(proc, pages[i], data, onFile[i]);
+        int frameNumber = claimFrame(proc, pages[i], false, data, fromPool);
+        if (isCodePage(proc, pages[i])) {
+            publishCode(frameNumber, proc, pages[i]);
+        }
+    }
+    int mapped = static_cast<int>(pages.size());
+    swappedInPageCount += mapped;
+    pagedInCount += mapped;
+    return mapped;
+}
+
+int MemoryManager::forkAddressSpace(Process* parent, Process* child) {
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    std::vector<uint8_t> pageData(frameSize);
+    int shared = 0;
+
+    parent->getPageTableRef().forEachMapped([&](int pageNumber, PageTableEntry& entry) {
+        // Swapped-out pages are copied to the child's backing slots now; only resident frames are shared
+        if (!entry.valid) {
+            if ((compressedPool.peek(parent->getId(), pageNumber, pageData.data()) ||
+                backingStore.readPage(parent->getId(), pageNumber, pageData.data())) && !isZeroPage(pageData.data())) {
+                backingStore.writePage(child->getId(), pageNumber, pageData.data());
             }
+            return;
+        }
+
+        int frameNumber = entry.frameNumber;
+        std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+        frameTable[frameNumber].sharers.push_back({ child, pageNumber });
+        entry.cow = true;
+
+        // The child has no backing copy of its own, so its mapping starts dirty
+        PageTableEntry& childEntry = child->getPageTableRef().entryFor(pageNumber);
+        childEntry.frameNumber = frameNumber;
+        childEntry.dirty = true;
+        childEntry.lastUseTick = entry.lastUseTick;
+        childEntry.cow = true;
+        childEntry.valid = true;
+        shared++;
+    });
+
+    forkCount++;
+    forkSharedFrameCount += shared;
+    return shared;
+}
+
+void MemoryManager::breakCopyOnWrite(Process* proc, int pageNumber) {
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    PageTableEntry* entry = proc->getPageTableRef().find(pageNumber);
+    if (!entry || !entry->valid || !entry->cow) {
+        return;  // Evicted, or already private, since the write saw the flag
+    }
+
+    int sharedFrame = entry->frameNumber;
+    std::vector<uint8_t> pageData(frameSize);
+    bool wasMerged;
+    {
+        std::lock_guard<std::mutex> frameGuard(frameLock(sharedFrame));
+        FrameInfo& frame = frameTable[sharedFrame];
+        if (frame.sharers.empty()) {
+            entry->cow = false;  // Every other process already copied the page or was evicted
+            return;
+        }
+        std::memcpy(pageData.data(), &physicalMemory[static_cast<size_t>(sharedFrame) * frameSize], frameSize);
+        wasMerged = frame.merged;
+        detachMapping(sharedFrame, proc, pageNumber, false);
+    }
 
-            //std::cout << "Page replacement: Evicting page " << victimPage
-                //<< " of process " << frame.processName << std::endl;
+    // The copy goes wherever a fault would put it, even into the shared frame if the policy evicts it
+    claimFrame(proc, pageNumber, false, pageData.data(), true);
+    if (wasMerged) {
+        unmergeCount++;
+    }
+    else {
+        cowFaultCount++;
+    }
+}
 
-            pagedOutCount++;
+int MemoryManager::scanForDuplicatePages() {
+    return scanForDuplicatePages(mergeScanBudget);
+}
 
-            // Replace victim with the new page
-            frame = { proc->getName(), pageNumber, true, true }; // referenced = true
-            pageTable[pageNumber] = { clockHand, true, false };
-            pagedInCount++;
+int MemoryManager::scanForDuplicatePages(int framesToScan) {
+    if (framesToScan <= 0) {
+        return 0;
+    }
 
-            // TOBEDELETED: MO2 backing store - try to load page data from backing store
-            std::unordered_map<uint32_t, uint16_t> pageData;
-            if (loadPageFromBackingStore(proc->getName(), pageNumber, pageData)) {
-                // TOBEDELETED: Restore page data from backing store
-                for (const auto& [address, value] : pageData) {
-                    proc->setMemoryValueAt(address, value);
-                }
+    std::lock_guard<std::mutex> mapLock(mapMutex);
+    int freed = 0;
+    for (int scanned = 0; scanned < framesToScan; ++scanned) {
+        if (mergeCursor >= numFrames) {
+            mergeCursor = 0;
+            mergeCandidates.clear();
+        }
+        int frameNumber = mergeCursor++;
+
+        // Huge pages must stay contiguous and code frames are already shared by program
+        uint64_t checksum = 0;
+        {
+            std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+            const FrameInfo& frame = frameTable[frameNumber];
+            if (frame.isOccupied && frame.hugeBase < 0 && !frame.sharedCode) {
+                checksum = hashPage(frameNumber);
             }
+        }
+
+        // A page that changed since the last pass is still being written; merging it would only unmerge again
+        bool stable = checksum != 0 && checksum == frameChecksums[frameNumber];
+        frameChecksums[frameNumber] = checksum;
+        if (!stable) {
+            continue;
+        }
 
-            int allocatedFrame = clockHand;
-            clockHand = (clockHand + 1) % numFrames;
-            return allocatedFrame;
+        auto [candidate, inserted] = mergeCandidates.emplace(checksum, frameNumber);
+        if (inserted || candidate->second == frameNumber) {
+            continue;
         }
+        if (mergeFrames(candidate->second, frameNumber)) {
+            freed++;
+        }
+        else {
+            candidate->second = frameNumber;  // The earlier frame changed or was evicted since it was hashed
+        }
+    }
+    return freed;
+}
 
-        // Give second chance
-        frame.referenced = false;
-        clockHand = (clockHand + 1) % numFrames;
+uint64_t MemoryManager::hashPage(int frameNumber) const {
+    // FNV-1a; equal hashes are confirmed byte for byte before merging
+    const uint8_t* data = &physicalMemory[static_cast<size_t>(frameNumber) * frameSize];
+    uint64_t hash = 14695981039346656037ull;
+    for (int i = 0; i < frameSize; ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
     }
+    return hash;
 }
 
-void MemoryManager::markPageAccessed(int frameNumber) {
-    if (frameNumber >= 0 && frameNumber < frameTable.size()) {
-        frameTable[frameNumber].referenced = true;
+bool MemoryManager::mergeFrames(int keepFrame, int dropFrame) {
+    // Two shards at once is safe: every path that holds more than one frame lock holds mapMutex too
+    std::unique_lock<std::mutex> keepGuard(frameLock(keepFrame));
+    std::unique_lock<std::mutex> dropGuard(frameLock(dropFrame), std::defer_lock);
+    if (&frameLock(dropFrame) != &frameLock(keepFrame)) {
+        dropGuard.lock();
+    }
+
+    FrameInfo& keep = frameTable[keepFrame];
+    FrameInfo& drop = frameTable[dropFrame];
+    auto eligible = [](const FrameInfo& frame) { return frame.isOccupied && frame.hugeBase < 0 && !frame.sharedCode; };
+    if (!eligible(keep) || !eligible(drop) ||
+        std::memcmp(&physicalMemory[static_cast<size_t>(keepFrame) * frameSize],
+            &physicalMemory[static_cast<size_t>(dropFrame) * frameSize], frameSize) != 0) {
+        return false;
+    }
+
+    // Every mapping of the duplicate moves to the kept frame; all of them become copy-on-write.
+    // Dirty bits stay with each mapping, so an eviction still writes back every page that needs it.
+    std::vector<FrameMapping> moved = drop.sharers;
+    moved.push_back({ drop.owner, drop.pageNumber });
+    for (const FrameMapping& mapping : moved) {
+        PageTableEntry* entry = mapping.process->getPageTableRef().find(mapping.pageNumber);
+        entry->frameNumber = keepFrame;
+        for (auto& tlb : tlbs) {
+            tlb->shootdown(mapping.process->getId(), mapping.pageNumber);
+        }
+        keep.sharers.push_back(mapping);
+    }
+    keep.owner->getPageTableRef().find(keep.pageNumber)->cow = true;
+    for (const FrameMapping& mapping : keep.sharers) {
+        mapping.process->getPageTableRef().find(mapping.pageNumber)->cow = true;
+    }
+    keep.merged = true;
+    if (drop.referenced) {
+        keep.referenced = true;
+    }
+
+    replacementPolicy->onUnmap(dropFrame);
+    resetFrame(dropFrame);
+    frameChecksums[dropFrame] = 0;
+    freeFrames.release(dropFrame);
+    mergeCount++;
+    return true;
+}
+
+MemorySnapshot MemoryManager::captureSnapshot() const {
+    MemorySnapshot snapshot;
+    snapshot.totalFrames = numFrames;
+    snapshot.usedFrames = freeFrames.getUsedCount();
+    snapshot.freeFrames = freeFrames.getFreeCount();
+    snapshot.pagedIn = pagedInCount;
+    snapshot.pagedOut = pagedOutCount;
+    snapshot.faults = faultCount;
+    snapshot.readaheadPages = readaheadPageCount;
+    snapshot.readaheadWaste = readaheadWasteCount;
+    snapshot.writebacks = writebackCount;
+    snapshot.poolStores = poolStoreCount;
+    snapshot.swapOutWrites = swapOutWriteCount;
+    snapshot.zeroPageDrops = zeroPageDropCount;
+    snapshot.cleanDiscards = cleanDiscardCount;
+    snapshot.blockedFaults = blockedFaultCount;
+    snapshot.pendingFaults = getPendingFaultCount();
+    snapshot.swappedOut = swappedOutPageCount;
+    snapshot.swappedIn = swappedInPageCount;
+    snapshot.hugePageSize = hugePageFrames > 1 ? hugePageFrames * frameSize : 0;
+    snapshot.hugePages = hugePageCount;
+    snapshot.hugeSplits = hugeSplitCount;
+    snapshot.hugeFallbacks = hugeFallbackCount;
+    snapshot.forks = forkCount;
+    snapshot.forkSharedFrames = forkSharedFrameCount;
+    snapshot.cowFaults = cowFaultCount;
+    snapshot.sharedCodeMaps = sharedCodeMapCount;
+    snapshot.merges = mergeCount;
+    snapshot.unmerges = unmergeCount;
+    for (const auto& tlb : tlbs) {
+        snapshot.tlbEntries = tlb->getEntryCount();
+        snapshot.tlbHits += tlb->getHitCount();
+        snapshot.tlbHugeHits += tlb->getHugeHitCount();
+        snapshot.tlbMisses += tlb->getMissCount();
+        snapshot.tlbShootdowns += tlb->getShootdownCount();
+        snapshot.tlbFlushes += tlb->getFlushCount();
+    }
+
+    // One frame lock at a time, so a console command never stalls more than one shard
+    for (int frameNumber = 0; frameNumber < numFrames; ++frameNumber) {
+        std::lock_guard<std::mutex> frameGuard(frameLock(frameNumber));
+        const FrameInfo& frame = frameTable[frameNumber];
+        if (frame.isOccupied) {
+            snapshot.residentPages[frame.processName]++;
+            if (frame.sharedCode && !frame.sharers.empty()) {
+                snapshot.sharedCodeFrames++;
+            }
+            if (frame.merged) {
+                snapshot.mergedFrames++;
+                snapshot.mergedPages += 1 + static_cast<int>(frame.sharers.size());
+            }
+        }
     }
+    return snapshot;
 }
 
 bool MemoryManager::allocateMemory(const String& processName) {
+    std::lock_guard<std::mutex> lock(allocationMutex);
     if (processToMemoryMap.find(processName) != processToMemoryMap.end()) {
         return true;
     }
@@ -144,6 +1042,15 @@ bool MemoryManager::allocateMemory(const String& processName) {
 
     int processMemorySizeNeeded = proc->getMemorySize();
 
+    if (useBuddyAllocator) {
+        int startAddr = buddyAllocator.allocate(processMemorySizeNeeded);
+        if (startAddr < 0) {
+            return false;
+        }
+        processToMemoryMap[processName] = startAddr;
+        return true;
+    }
+
     // Try to allocate a memory block (just for memory_stamp)
     for (auto it = memoryBlocks.begin(); it != memoryBlocks.end(); ++it) {
         if (!it->isAllocated && it->size >= processMemorySizeNeeded) {
@@ -177,12 +1084,16 @@ bool MemoryManager::allocateMemory(const String& processName) {
 
 
 bool MemoryManager::deallocateMemory(const String& processName) {
+    std::lock_guard<std::mutex> lock(allocationMutex);
     auto mapIt = processToMemoryMap.find(processName);
     if (mapIt == processToMemoryMap.end()) {
         return false;
     }
     int startAddr = mapIt->second;
     processToMemoryMap.erase(mapIt);
+    if (useBuddyAllocator) {
+        return buddyAllocator.release(startAddr);
+    }
     for (auto& block : memoryBlocks) {
         if (block.isAllocated && block.startAddress == startAddr && block.processName == processName) {
             block.isAllocated = false;
@@ -211,43 +1122,118 @@ void MemoryManager::mergeAdjacentFreeBlocks() {
 }
 
 bool MemoryManager::hasMemoryFor(const String& processName) const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
     if (processToMemoryMap.find(processName) != processToMemoryMap.end()) {
         return true;
     }
+
+    // Sized like allocateMemory: by the process's own requirement when it is registered
+    auto procIt = allProcesses.find(processName);
+    int bytesNeeded = (procIt != allProcesses.end() && procIt->second) ? procIt->second->getMemorySize() : processMemorySize;
+    if (useBuddyAllocator) {
+        return buddyAllocator.canAllocate(bytesNeeded);
+    }
     for (const auto& block : memoryBlocks) {
-        if (!block.isAllocated && block.size >= processMemorySize) {
+        if (!block.isAllocated && block.size >= bytesNeeded) {
             return true;
         }
     }
     return false;
 }
 
+bool MemoryManager::holdsMemory(const String& processName) const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
+    return processToMemoryMap.find(processName) != processToMemoryMap.end();
+}
+
 int MemoryManager::getProcessesInMemory() const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
     return static_cast<int>(processToMemoryMap.size());
 }
 
 int MemoryManager::calculateExternalFragmentation() const {
+    return sumFreeBlockBytes() - findLargestFreeBlock();
+}
+
+int MemoryManager::sumFreeBlockBytes() const {
+    if (useBuddyAllocator) {
+        return buddyAllocator.getFreeBytes();
+    }
     int totalFreeMemory = 0;
-    int largestFreeBlock = 0;
     for (const auto& block : memoryBlocks) {
         if (!block.isAllocated) {
             totalFreeMemory += block.size;
+        }
+    }
+    return totalFreeMemory;
+}
+
+int MemoryManager::findLargestFreeBlock() const {
+    if (useBuddyAllocator) {
+        return buddyAllocator.getLargestFreeBlock();
+    }
+    int largestFreeBlock = 0;
+    for (const auto& block : memoryBlocks) {
+        if (!block.isAllocated) {
             largestFreeBlock = std::max(largestFreeBlock, block.size);
         }
     }
-    return totalFreeMemory - largestFreeBlock;
+    return largestFreeBlock;
+}
+
+int MemoryManager::getFreeBlockBytes() const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
+    return sumFreeBlockBytes();
+}
+
+int MemoryManager::getLargestFreeBlockBytes() const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
+    return findLargestFreeBlock();
+}
+
+int MemoryManager::getExternalFragmentationBytes() const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
+    return calculateExternalFragmentation();
+}
+
+int MemoryManager::getInternalFragmentationBytes() const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
+    // First-fit carves blocks to the exact request
+    return useBuddyAllocator ? buddyAllocator.getInternalFragmentation() : 0;
+}
+
+std::vector<MemoryBlock> MemoryManager::getMemoryLayout() const {
+    std::vector<MemoryBlock> blocks;
+    if (useBuddyAllocator) {
+        std::map<int, String> owners;
+        for (const auto& [name, startAddr] : processToMemoryMap) {
+            owners[startAddr] = name;
+        }
+        for (const auto& [startAddr, size] : buddyAllocator.getAllocatedBlocks()) {
+            blocks.push_back(MemoryBlock(startAddr, size, owners[startAddr], true));
+        }
+        for (const auto& [startAddr, size] : buddyAllocator.getFreeBlocks()) {
+            blocks.push_back(MemoryBlock(startAddr, size, "", false));
+        }
+    }
+    else {
+        blocks = memoryBlocks;
+    }
+    std::sort(blocks.begin(), blocks.end(), [](const MemoryBlock& a, const MemoryBlock& b) {
+        return a.startAddress < b.startAddress;
+        });
+    return blocks;
 }
 
 int MemoryManager::getExternalFragmentationKB() const {
+    std::lock_guard<std::mutex> lock(allocationMutex);
     return calculateExternalFragmentation() / 1024;
 }
 
 String MemoryManager::generateASCIIMemoryMap() const {
     std::stringstream ss;
-    std::vector<MemoryBlock> sortedBlocks = memoryBlocks;
-    std::sort(sortedBlocks.begin(), sortedBlocks.end(), [](const MemoryBlock& a, const MemoryBlock& b) {
-        return a.startAddress < b.startAddress;
-        });
+    std::lock_guard<std::mutex> lock(allocationMutex);
+    std::vector<MemoryBlock> sortedBlocks = getMemoryLayout();
     ss << "----end---- = " << totalMemorySize << std::endl;
     for (auto it = sortedBlocks.rbegin(); it != sortedBlocks.rend(); ++it) {
         int endAddr = it->startAddress + it->size;
@@ -279,10 +1265,7 @@ void MemoryManager::generateMemorySnapshot(int quantumCycle) const {
     localtime_r(&now, &tm);
 #endif
 
-    int pagesUsed = 0;
-    for (const auto& frame : frameTable) {
-        if (!frame.processName.empty()) pagesUsed++;
-    }
+    int pagesUsed = getUsedFrameCount();
 
     file << "Timestamp: (" << std::put_time(&tm, "%m/%d/%Y %I:%M:%S%p") << ")\n";
     file << "Number of used frames: " << pagesUsed << "\n";
@@ -292,8 +1275,10 @@ void MemoryManager::generateMemorySnapshot(int quantumCycle) const {
     file << "Frame | Process | Page # | Referenced\n";
     file << "--------------------------------------\n";
 
-    for (int i = 0; i < frameTable.size(); ++i) {
-        const FrameInfo& frame = frameTable[i];
+    for (int i = 0; i < numFrames; ++i) {
+        std::unique_lock<std::mutex> frameGuard(frameLock(i));
+        const FrameInfo frame = frameTable[i];
+        frameGuard.unlock();
         if (!frame.processName.empty()) {
             file << std::setw(5) << i << " | "
                 << std::setw(7) << frame.processName << " | "
@@ -308,17 +1293,18 @@ void MemoryManager::generateMemorySnapshot(int quantumCycle) const {
 void MemoryManager::printMemoryStatus() const {
     std::cout << "=== Memory Status ===" << std::endl;
     std::cout << "Processes in memory: " << getProcessesInMemory() << std::endl;
+    std::cout << "Allocator: " << getAllocatorName() << std::endl;
     std::cout << "External fragmentation: " << getExternalFragmentationKB() << " KB" << std::endl;
     std::cout << std::endl;
     std::cout << generateASCIIMemoryMap() << std::endl;
 }
 
 int MemoryManager::getUsedFrameCount() const {
-    return static_cast<int>(std::count(freeFrameList.begin(), freeFrameList.end(), false));
+    return freeFrames.getUsedCount();
 }
 
 int MemoryManager::getFreeFrameCount() const {
-    return static_cast<int>(std::count(freeFrameList.begin(), freeFrameList.end(), true));
+    return freeFrames.getFreeCount();
 }
 
 int MemoryManager::getTotalFrames() const {
@@ -336,108 +1322,39 @@ void MemoryManager::dumpBackingStoreToFile(const std::string& filename) const {
         return;
     }
 
-    outFile << "=== Backing Store Dump ===\n\n";
+    outFile << "=== Backing Store Dump ===\n";
+    outFile << "Slots used: " << backingStore.getUsedSlotCount() << " / " << backingStore.getSlotCount()
+        << " (" << frameSize << " bytes each)\n";
+    outFile << "Compressed pool: " << compressedPool.getStoredPageCount() << " pages in "
+        << compressedPool.getUsedBytes() << " / " << compressedPool.getCapacityBytes() << " bytes\n\n";
+
+    std::map<String, std::shared_ptr<Process>> processes;
+    {
+        std::lock_guard<std::mutex> lock(allocationMutex);
+        processes.insert(allProcesses.begin(), allProcesses.end());
+    }
 
-    for (const auto& [processName, processPtr] : allProcesses) {
+    for (const auto& [processName, processPtr] : processes) {
         outFile << "Process: " << processName << "\n";
-        const auto& pageTable = processPtr->getPageTable();
 
-        for (const auto& [pageNum, entry] : pageTable) {
+        // Page-table structure is stable under the map lock; slot and pool lookups lock on their own
+        std::lock_guard<std::mutex> mapLock(mapMutex);
+        const PageTable& pageTable = processPtr->getPageTable();
+        outFile << "  Page table: " << pageTable.getLeafCount() << " leaves, "
+            << pageTable.getFootprintBytes() << " bytes\n";
+        pageTable.forEachMapped([&](int pageNum, const PageTableEntry& entry) {
+            int slot = backingStore.getSlot(processPtr->getId(), pageNum);
             outFile << "  Page " << pageNum << " => "
                 << (entry.valid ? "Frame " + std::to_string(entry.frameNumber) : "Not in memory")
+                << (slot >= 0 ? " | Slot " + std::to_string(slot) : "")
+                << (entry.valid && entry.huge ? " | Huge" : "")
+                << (entry.valid && entry.cow ? " | COW" : "")
+                << (compressedPool.contains(processPtr->getId(), pageNum) ? " | Compressed" : "")
                 << "\n";
-        }
+        });
 
         outFile << "\n";
     }
 
     outFile.close();
 }
-
-// TOBEDELETED: MO2 backing store - save actual page data to file
-void MemoryManager::savePageToBackingStore(const String& processName, int pageNumber, const std::unordered_map<uint32_t, uint16_t>& pageData) {
-    // TOBEDELETED: Create backing store data file with binary format for efficiency
-    std::string filename = "csopesy-backing-store-data.bin";
-    std::ofstream outFile(filename, std::ios::binary | std::ios::app);
-    if (!outFile.is_open()) {
-        std::cerr << "Error: Failed to open backing store data file for writing.\n";
-        return;
-    }
-    
-    // TOBEDELETED: Write page header: process name length, process name, page number, data count
-    uint32_t nameLength = static_cast<uint32_t>(processName.length()); // TOBEDELETED: Fix C4267 warning
-    outFile.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
-    outFile.write(processName.c_str(), nameLength);
-    outFile.write(reinterpret_cast<const char*>(&pageNumber), sizeof(pageNumber));
-    
-    uint32_t dataCount = static_cast<uint32_t>(pageData.size()); // TOBEDELETED: Fix C4267 warning
-    outFile.write(reinterpret_cast<const char*>(&dataCount), sizeof(dataCount));
-    
-    // TOBEDELETED: Write page data: address-value pairs
-    for (const auto& [address, value] : pageData) {
-        outFile.write(reinterpret_cast<const char*>(&address), sizeof(address));
-        outFile.write(reinterpret_cast<const char*>(&value), sizeof(value));
-    }
-    
-    outFile.close();
-}
-
-// TOBEDELETED: MO2 backing store - load actual page data from file
-bool MemoryManager::loadPageFromBackingStore(const String& processName, int pageNumber, std::unordered_map<uint32_t, uint16_t>& pageData) {
-    // TOBEDELETED: Read backing store data file to find the page
-    std::string filename = "csopesy-backing-store-data.bin";
-    std::ifstream inFile(filename, std::ios::binary);
-    if (!inFile.is_open()) {
-        return false; // TOBEDELETED: No backing store file exists yet
-    }
-    
-    // TOBEDELETED: Search through the file for the matching process and page
-    while (inFile.good()) {
-        uint32_t nameLength;
-        if (!inFile.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength))) {
-            break; // TOBEDELETED: End of file
-        }
-        
-        std::string storedProcessName(nameLength, '\0');
-        if (!inFile.read(&storedProcessName[0], nameLength)) {
-            break;
-        }
-        
-        int storedPageNumber;
-        if (!inFile.read(reinterpret_cast<char*>(&storedPageNumber), sizeof(storedPageNumber))) {
-            break;
-        }
-        
-        uint32_t dataCount;
-        if (!inFile.read(reinterpret_cast<char*>(&dataCount), sizeof(dataCount))) {
-            break;
-        }
-        
-        if (storedProcessName == processName && storedPageNumber == pageNumber) {
-            pageData.clear();
-            for (uint32_t i = 0; i < dataCount; ++i) {
-                uint32_t address;
-                uint16_t value;
-                if (!inFile.read(reinterpret_cast<char*>(&address), sizeof(address)) ||
-                    !inFile.read(reinterpret_cast<char*>(&value), sizeof(value))) {
-                    return false;
-                }
-                pageData[address] = value;
-            }
-            inFile.close();
-            return true;
-        } else {
-            for (uint32_t i = 0; i < dataCount; ++i) {
-                uint32_t address;
-                uint16_t value;
-                if (!inFile.read(reinterpret_cast<char*>(&address), sizeof(address)) ||
-                    !inFile.read(reinterpret_cast<char*>(&value), sizeof(value))) {
-                    break;
-                }
-            }
-        }
-    }
-    
-    inFile.close();
-    return false; // TOBEDELETED: Page not found in backing store
-}
@@ -1,11 +1,26 @@
 #pragma once
 #include "TypedefRepo.h"
 #include "CoreManager.h"
+#include "FrameBitmap.h"
+#include "BackingStore.h"
+#include "BuddyAllocator.h"
+#include "CompressedPool.h"
+#include "ReplacementPolicy.h"
+#include "TLB.h"
+#include "AtomicField.h"
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <queue>
+#include <deque>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 
 class Process;
+struct ProgramImage;
 
 struct MemoryBlock {
     int startAddress;
@@ -18,63 +33,329 @@ struct MemoryBlock {
     }
 };
 
+// One process's mapping of a frame it shares with others
+struct FrameMapping {
+    Process* process;
+    int pageNumber;
+
+    bool operator==(const FrameMapping& other) const = default;
+};
+
+// One entry per physical frame; doubles as the reverse (inverted) page table.
+// Ownership fields change only with both the map lock and the frame's lock held;
+// the access bits are set on every reference without the map lock. After a fork the
+// frame is mapped copy-on-write by the owner and its sharers; a shared code frame is
+// mapped read-only by every process running the same program; a merged frame is mapped
+// copy-on-write by every page found to hold the same contents, at any page number.
+// A default-constructed FrameInfo is a free frame
 struct FrameInfo {
     String processName;
-    int pageNumber;
-    bool isOccupied;
-    bool referenced; // for clocked algo
+    int pageNumber = -1;
+    bool isOccupied = false;
+    AtomicField<bool> referenced = false; // for clocked algo
+    Process* owner = nullptr;  // process whose page table maps this frame (nullptr if free)
+    AtomicField<bool> prefetched = false; // mapped by readahead and not touched since
+    int hugeBase = -1;  // First frame of the huge page this frame is part of (-1 for a base page); map lock only
+    std::vector<FrameMapping> sharers;  // Mappings besides the owner's (fork, shared code or merged pages)
+    bool sharedCode = false;        // Published in codeFrames for other processes running the same program
+    bool merged = false;            // Duplicate frames were folded into this one by the same-page scanner
+
+    bool maps(const Process* proc, int page) const {
+        return (owner == proc && pageNumber == page) || std::any_of(sharers.begin(), sharers.end(),
+            [&](const FrameMapping& m) { return m.process == proc && m.pageNumber == page; });
+    }
 };
 
+// Point-in-time copy of the paging state for console commands, so they never walk live tables
+struct MemorySnapshot {
+    int totalFrames = 0;
+    int usedFrames = 0;
+    int freeFrames = 0;
+    int pagedIn = 0;
+    int pagedOut = 0;
+    int faults = 0;
+    int readaheadPages = 0;
+    int readaheadWaste = 0;
+    int writebacks = 0;                     // Dirty mappings written to the backing-store file
+    int poolStores = 0;                     // Dirty mappings kept in the compressed pool instead
+    int swapOutWrites = 0;                  // Pages written in whole-process swap-out batches
+    int zeroPageDrops = 0;
+    int cleanDiscards = 0;                  // Clean mappings dropped without a write
+    int blockedFaults = 0;
+    int pendingFaults = 0;
+    int swappedOut = 0;
+    int swappedIn = 0;
+    int hugePageSize = 0;                   // Bytes (0 = huge pages off)
+    int hugePages = 0;                      // Faults served with a whole huge page
+    int hugeSplits = 0;
+    int hugeFallbacks = 0;                  // Eligible faults that found no free aligned run
+    int forks = 0;
+    int forkSharedFrames = 0;               // Frames shared copy-on-write at fork time
+    int cowFaults = 0;                      // Writes that copied a shared frame
+    int sharedCodeFrames = 0;               // Code frames currently mapped by more than one process
+    int sharedCodeMaps = 0;                 // Minor faults served by another process's code frame
+    int mergedFrames = 0;                   // Frames the same-page scanner left holding several pages
+    int mergedPages = 0;                    // Pages mapped onto those frames
+    int merges = 0;
+    int unmerges = 0;                       // Writes that copied a merged frame
+    int tlbEntries = 0;                     // Per core
+    long long tlbHits = 0;
+    long long tlbHugeHits = 0;
+    long long tlbMisses = 0;
+    long long tlbShootdowns = 0;
+    long long tlbFlushes = 0;
+    std::map<String, int> residentPages;    // processName -> frames it holds
+};
+
+// A blocked page fault waiting for the pager; pages are mapped once readyTick is reached
+struct PageFaultRequest {
+    Process* process;
+    std::vector<int> pages;
+    int codePage;       // Faulting code page to read ahead from (-1 if the code page was resident)
+    long long readyTick;
+};
+
+// Everything besides the memory and frame size that a MemoryManager is built with. The defaults are
+// plain demand paging: no write-behind, compressed pool, pager latency, readahead, huge pages or merging.
+struct MemorySettings {
+    String policyName = "clock";
+    String allocatorName = "firstfit";
+    int pagerQueueSize = 0;
+    int compressedPoolSize = 0;
+    int pageFaultLatency = 0;
+    int readaheadWindow = 0;
+    int hugePageSize = 0;
+    int hugePageThreshold = 0;
+    int tlbEntries = 0;
+    int tlbCount = 1;               // One TLB per core
+    int mergeScanPages = 0;
+    int processMemorySize = 0;
+
+    static MemorySettings fromConfig();  // The live configuration's values
+};
+
+// Locking, in acquisition order:
+//   mapMutex      - replacement policy, frame ownership, page-table structure and readahead
+//                   state. Held only to claim or evict frames; fault I/O happens outside it.
+//   frameLocks[]  - sharded by frame number: frame contents and FrameInfo. Every word access
+//                   re-checks ownership under the frame's lock, so a stale translation retries.
+//   BackingStore, CompressedPool and the per-core TLBs lock internally (TLB entries are atomic).
+// allocationMutex (process blocks and registry) and faultQueueMutex are never held with the
+// others. A process's page table only changes structure on the thread running it, so the owner
+// reads it unlocked and everyone else takes mapMutex. The free-frame bitmap is lock-free.
 class MemoryManager {
 private:
+    static const int FRAME_LOCK_SHARDS = 16;
+
     int totalMemorySize;
     int frameSize;
     int numFrames;
     int processMemorySize;
-    int pagedInCount = 0;
-    int pagedOutCount = 0;
-    int clockHand = 0;  // Points to next frame to consider for replacement
+    std::atomic<int> pagedInCount{ 0 };
+    std::atomic<int> pagedOutCount{ 0 };
+    // Every mapping an eviction drops lands in exactly one of these; pagedOutCount counts frames,
+    // so with fork or merge sharers the mappings outnumber it
+    std::atomic<int> writebackCount{ 0 };     // Evictions that wrote a dirty page to the backing store
+    std::atomic<int> poolStoreCount{ 0 };     // Dirty evictions stored in the compressed pool
+    std::atomic<int> swapOutWriteCount{ 0 };  // Pages written by swapOutProcess batches, clean ones included
+    std::atomic<int> zeroPageDropCount{ 0 };  // Dirty evictions skipped because the page was all zero
+    std::atomic<int> cleanDiscardCount{ 0 };  // Clean evictions dropped with no write
+    std::atomic<int> faultCount{ 0 };         // Demand page-ins (readahead pages are not faults)
+    std::atomic<int> readaheadPageCount{ 0 }; // Pages mapped ahead of a sequential code fault
+    std::atomic<int> readaheadWasteCount{ 0 };// Readahead pages evicted before they were touched
+    std::atomic<int> swappedOutPageCount{ 0 };// Pages evicted by whole-process swap-out
+    std::atomic<int> swappedInPageCount{ 0 }; // Pages brought back in one batch by whole-process swap-in
+    std::atomic<int> hugePageCount{ 0 };      // Faults that mapped a whole huge page
+    std::atomic<int> hugeSplitCount{ 0 };     // Huge pages broken up to evict one of their frames
+    std::atomic<int> hugeFallbackCount{ 0 };  // Huge-page faults served with a base page for lack of a free run
+    std::atomic<int> forkCount{ 0 };
+    std::atomic<int> forkSharedFrameCount{ 0 };// Resident frames a fork shared instead of copying
+    std::atomic<int> cowFaultCount{ 0 };      // Writes to a shared frame that took a private copy
+    std::atomic<int> sharedCodeMapCount{ 0 }; // Code faults that mapped another process's frame without I/O
+    std::atomic<int> mergeCount{ 0 };         // Duplicate frames folded into an identical one
+    std::atomic<int> unmergeCount{ 0 };       // Writes that took a private copy of a merged frame
+    int readaheadLimit;         // Largest readahead window in pages (0 = readahead off)
+    int hugePageFrames;         // Frames per huge page (1 = huge pages off)
+    int hugePageThreshold;      // Smallest process, in bytes, that gets huge pages
+    BackingStore backingStore;                      // Slot-indexed swap file for evicted pages
+    CompressedPool compressedPool;                  // Optional compressed RAM tier in front of the swap file
+    std::unique_ptr<ReplacementPolicy> replacementPolicy; // Chooses eviction victims
+    std::vector<std::unique_ptr<TLB>> tlbs;         // tlbs[coreId]; each allocated separately so cores never share a line
 
+    mutable std::mutex mapMutex;
+    mutable std::array<std::mutex, FRAME_LOCK_SHARDS> frameLocks;
+    mutable std::mutex allocationMutex;
+    mutable std::mutex faultQueueMutex;
 
-    std::vector<MemoryBlock> memoryBlocks;          // For non-paging allocation (legacy)
-    std::vector<bool> freeFrameList;                // true if frame is free
+    int pageFaultLatency;                           // Pager service time per blocked fault, in ticks
+    std::deque<PageFaultRequest> faultQueue;        // Blocked faults in service order
+    std::atomic<long long> currentTick{ 0 };        // Last tick the scheduler reported (pager and working sets)
+    long long pagerBusyUntil = 0;                   // Tick the pager finishes its queued work
+    std::atomic<int> blockedFaultCount{ 0 };        // Faults that took a process off its core
+
+
+    bool useBuddyAllocator;                         // memory-allocator: buddy instead of first-fit
+    // Resident code pages by (program, code segment start, page); map lock only. Processes running
+    // the same image at the same code address map these frames instead of reading their own copy.
+    std::map<std::tuple<const ProgramImage*, int, int>, int> codeFrames;
+    // Pages each swapped-out process had resident, by process id; map lock only. Swap-in maps them back in one batch.
+    std::unordered_map<int, std::vector<int>> swappedOutPages;
+
+    // Same-page merging: a few frames are hashed each tick. A frame whose contents did not change
+    // over a whole pass and match a frame seen earlier in the pass is folded into it copy-on-write.
+    int mergeScanBudget;                            // Frames hashed per tick (0 = scanner off)
+    int mergeCursor = 0;                            // Next frame to hash; map lock only, like the rest
+    std::vector<uint64_t> frameChecksums;           // Contents hash from the previous pass (0 = not eligible)
+    std::unordered_map<uint64_t, int> mergeCandidates; // Contents hash -> first stable frame this pass
+    std::vector<MemoryBlock> memoryBlocks;          // For non-paging allocation (legacy, first-fit)
+    BuddyAllocator buddyAllocator;                  // Whole-process blocks when useBuddyAllocator is set
+    FrameBitmap freeFrames;                         // Free-frame bitmap with maintained counts
     std::vector<FrameInfo> frameTable;              // frameTable[frameNumber] = info
-    std::queue<int> freeFrames;                     // Available frames
     std::map<String, int> processToMemoryMap;       // processName -> startAddress (for block allocation)
+    std::vector<uint8_t> physicalMemory;            // numFrames * frameSize bytes, frame N starts at N * frameSize
 
     std::map<std::pair<String, int>, int> pageTable;
     const std::map<std::pair<String, int>, int>& getPageTable() const {
         return pageTable;
     }
 
+    std::mutex& frameLock(int frameNumber) const { return frameLocks[frameNumber % FRAME_LOCK_SHARDS]; }
+
+    // Maps a frame to the page and fills it from pageData; a prefetch gets -1 rather than evicting. Assumes mapMutex held.
+    int claimFrame(Process* proc, int pageNumber, bool prefetch, const uint8_t* pageData, bool dirty);
+    void installPage(int frameNumber, bool evict, Process* proc, int pageNumber, bool prefetch,
+        const uint8_t* pageData, bool dirty, int hugeBase); // Takes the frame's lock; assumes mapMutex held
+    void evictFrame(int frameNumber, bool writeBack = true);  // Assumes mapMutex and the frame's lock held
+    FrameInfo& resetFrame(int frameNumber);  // Marks the frame free, sharing state included; assumes the frame's lock held
+    // Drops one process's mapping of a frame, writing its copy back first if asked and dirty.
+    // detachMapping leaves the frame resident for its other mappers. Both assume mapMutex and the frame's lock held.
+    void unmapPage(int frameNumber, Process* mapper, int pageNumber, bool writeBack);
+    void detachMapping(int frameNumber, Process* proc, int pageNumber, bool writeBack);
+    void breakCopyOnWrite(Process* proc, int pageNumber);  // Gives proc a private copy of a shared page
+
+    // Shared code: code pages are never written, so one resident copy serves every process running the program
+    bool isCodePage(Process* proc, int pageNumber) const;
+    std::tuple<const ProgramImage*, int, int> codeKey(Process* proc, int pageNumber) const;
+    int mapSharedCode(Process* proc, int pageNumber);           // Frame number, or -1 if none resident; assumes mapMutex held
+    void publishCode(int frameNumber, Process* proc, int pageNumber); // Assumes mapMutex held
+
+    uint64_t hashPage(int frameNumber) const;   // Assumes the frame's lock held
+    bool mergeFrames(int keepFrame, int dropFrame); // Assumes mapMutex held; false if they no longer match
+
+    // Page images for a fault: batch-read outside mapMutex, then completed from the pool or zero-filled under it
+    void readPageImages(Process* proc, const std::vector<int>& pages, std::vector<uint8_t>& buffer, std::vector<bool>& onFile);
+    bool finishPageImage(Process* proc, int pageNumber, uint8_t* pageData, bool onFile); // Returns true if loaded from the pool
+
+    // Huge pages: an aligned run of hugePageFrames pages mapped onto an aligned run of free frames
+    bool usesHugePage(Process* proc, int pageNumber) const;
+    int allocateHugePage(Process* proc, int pageNumber);
+    void splitHugePage(int firstFrame);  // Assumes mapMutex held
+    void noteAccess(int frameNumber);  // Replacement-policy side of a reference; takes mapMutex
+    void invalidateStaleTlb(Process* proc, int pageNumber); // Drops a translation that failed the owner re-check
+    bool isZeroPage(const uint8_t* pageData) const;
+
     void mergeAdjacentFreeBlocks();
+    // Block-allocator queries; assume allocationMutex held
     int calculateExternalFragmentation() const;
+    int sumFreeBlockBytes() const;
+    int findLargestFreeBlock() const;
+    std::vector<MemoryBlock> getMemoryLayout() const; // Allocated and free blocks in address order
     std::unordered_map<String, std::shared_ptr<Process>> allProcesses;
 
 public:
     MemoryManager();
+    MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile);
+    MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile, const String& policyName);
+    MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile, const String& policyName,
+        const String& allocatorName);
+    MemoryManager(int totalMemory, int frameBytes, const String& backingStoreFile, const MemorySettings& settings);
     ~MemoryManager() = default;
 
     // Demand paging
     int allocatePage(Process* proc, int pageNumber); // Returns frameNumber or -1 on fail
+    int readaheadCode(Process* proc, int faultPage); // Maps the next code pages into free frames after a blocking fault; returns pages mapped
+    bool tryMapSharedCode(Process* proc, int pageNumber); // Minor fault: maps a resident copy another process loaded
     bool deallocatePage(const String& processName, int pageNumber); // Optional for replacement
 
-    int getPagedInCount() const { return pagedInCount; }
-    int getPagedOutCount() const { return pagedOutCount; }
+    int getPagedInCount() const { return pagedInCount.load(); }
+    int getPagedOutCount() const { return pagedOutCount.load(); }
+    int getWritebackCount() const { return writebackCount.load(); }
+    int getPoolStoreCount() const { return poolStoreCount.load(); }
+    int getSwapOutWriteCount() const { return swapOutWriteCount.load(); }
+    int getZeroPageDropCount() const { return zeroPageDropCount.load(); }
+    int getCleanDiscardCount() const { return cleanDiscardCount.load(); }
+    int getFaultCount() const { return faultCount.load(); }
+    int getReadaheadPageCount() const { return readaheadPageCount.load(); }
+    int getReadaheadWasteCount() const { return readaheadWasteCount.load(); }
+    int getSwappedOutPageCount() const { return swappedOutPageCount.load(); }
+    int getSwappedInPageCount() const { return swappedInPageCount.load(); }
+    int getHugePageCount() const { return hugePageCount.load(); }
+    int getHugeSplitCount() const { return hugeSplitCount.load(); }
+    int getHugeFallbackCount() const { return hugeFallbackCount.load(); }
+    int getForkSharedFrameCount() const { return forkSharedFrameCount.load(); }
+    int getCowFaultCount() const { return cowFaultCount.load(); }
+    int getSharedCodeMapCount() const { return sharedCodeMapCount.load(); }
+    int getMergeCount() const { return mergeCount.load(); }
+    int getUnmergeCount() const { return unmergeCount.load(); }
+    MemorySnapshot captureSnapshot() const;  // Takes each frame lock briefly; never blocks faults for long
+
+    // Working sets: pages a process referenced within the last `window` ticks
+    int getWorkingSetSize(Process* proc, int window) const;
+    double getResidentRatio(Process* proc) const;  // Resident share of the pages the process has touched (0 if none)
+    // Whole-process swapping: swap-out evicts every resident page and writes them to the backing store
+    // as one sequential batch; swap-in reads that batch back and maps it before the process runs again
+    int swapOutProcess(Process* proc); // Returns frames freed
+    int swapInProcess(Process* proc);  // Returns pages mapped
+
+    // Same-page merging: hashes the next merge-scan-pages frames; returns frames freed. Called once per tick.
+    int scanForDuplicatePages();
+    int scanForDuplicatePages(int framesToScan);   // Same, with an explicit budget
+
+    // Fork: the child maps every resident page of the parent copy-on-write; returns frames shared
+    int forkAddressSpace(Process* parent, Process* child);
+    BackingStore& getBackingStore() { return backingStore; }
+    const BackingStore& getBackingStore() const { return backingStore; }
+    const CompressedPool& getCompressedPool() const { return compressedPool; }
+    const char* getReplacementPolicyName() const { return replacementPolicy->getName(); }
+
+    // Blocking page faults (serviced by the scheduler tick, one request at a time)
+    bool usesBlockingFaults() const { return pageFaultLatency > 0; }
+    void queuePageFault(Process* proc, const std::vector<int>& pages, int codePage);
+    std::vector<Process*> servicePageFaults(long long tick); // Returns processes whose pages are now resident
+    int getBlockedFaultCount() const { return blockedFaultCount.load(); }
+    int getPendingFaultCount() const;
+
 
+    // Physical memory access (offset is a byte offset inside the frame). The mapped variants
+    // check under the frame's lock that it still holds the page and return false if it was evicted.
+    uint16_t readPhysicalWord(int frameNumber, int offset) const;
+    void writePhysicalWord(int frameNumber, int offset, uint16_t value);
+    bool readMappedWord(Process* proc, int pageNumber, int frameNumber, int offset, uint16_t& value);
+    bool writeMappedWord(Process* proc, int pageNumber, int frameNumber, int offset, uint16_t value);
+    bool readPageContents(Process* proc, int pageNumber, uint8_t* pageData);
 
-    void savePageToBackingStore(const String& processName, int pageNumber, const std::unordered_map<uint32_t, uint16_t>& pageData);
-    bool loadPageFromBackingStore(const String& processName, int pageNumber, std::unordered_map<uint32_t, uint16_t>& pageData);
+    // Per-core TLBs. coreId < 0 (work done off a core) always misses and is never cached.
+    int lookupTlb(int coreId, int processId, int pageNumber);   // Frame number, or -1 on a miss
+    void fillTlb(int coreId, int processId, int pageNumber, int frameNumber, bool huge);
+    void switchTlbContext(int coreId, int processId);           // Called when a process is dispatched to a core
 
     // Whole-process allocation (FCFS-style)
     bool allocateMemory(const String& processName);
-    void markPageAccessed(int frameNumber);
+    // proc and pageNumber name the mapping that referenced it (default: the owner's); a process may map
+    // a merged frame at several page numbers, so the page is needed to stamp the right entry
+    void markPageAccessed(int frameNumber, Process* proc = nullptr, int pageNumber = -1);
     bool deallocateMemory(const String& processName);
 
     // Memory status
     bool hasMemoryFor(const String& processName) const;
+    bool holdsMemory(const String& processName) const;  // Has a whole-process block allocated
     int getProcessesInMemory() const;
     int getExternalFragmentationKB() const;
+    int getExternalFragmentationBytes() const;
+    int getInternalFragmentationBytes() const; // Rounding waste inside allocated blocks (buddy only)
+    int getFreeBlockBytes() const;
+    int getLargestFreeBlockBytes() const;
+    const char* getAllocatorName() const { return useBuddyAllocator ? "buddy" : "firstfit"; }
 
     // Visualization
     String generateASCIIMemoryMap() const;
@@ -86,7 +367,7 @@ public:
     // Debug
     void printMemoryStatus() const;
 
-    void setProcessMap(const std::unordered_map<String, std::shared_ptr<Process>>& map);
+    void registerProcess(const std::shared_ptr<Process>& process);
 
 
     // Accessors
@@ -0,0 +1,53 @@
+#include "PageTable.h"
+
+PageTable::PageTable(const PageTable& other) {
+    *this = other;
+}
+
+PageTable& PageTable::operator=(const PageTable& other) {
+    if (this == &other) {
+        return *this;
+    }
+    directory.clear();
+    directory.resize(other.directory.size());
+    for (size_t dir = 0; dir < other.directory.size(); ++dir) {
+        if (other.directory[dir]) {
+            directory[dir] = std::make_unique<Leaf>(*other.directory[dir]);
+        }
+    }
+    leafCount = other.leafCount;
+    return *this;
+}
+
+const PageTableEntry* PageTable::find(int pageNumber) const {
+    size_t dir = static_cast<size_t>(pageNumber) >> LEAF_BITS;
+    if (pageNumber < 0 || dir >= directory.size() || !directory[dir]) {
+        return nullptr;
+    }
+    return &(*directory[dir])[pageNumber & (LEAF_SIZE - 1)];
+}
+
+PageTableEntry* PageTable::find(int pageNumber) {
+    return const_cast<PageTableEntry*>(static_cast<const PageTable*>(this)->find(pageNumber));
+}
+
+PageTableEntry& PageTable::entryFor(int pageNumber) {
+    size_t dir = static_cast<size_t>(pageNumber) >> LEAF_BITS;
+    if (dir >= directory.size()) {
+        directory.resize(dir + 1);
+    }
+    if (!directory[dir]) {
+        directory[dir] = std::make_unique<Leaf>();
+        leafCount++;
+    }
+    return (*directory[dir])[pageNumber & (LEAF_SIZE - 1)];
+}
+
+bool PageTable::isResident(int pageNumber) const {
+    const PageTableEntry* entry = find(pageNumber);
+    return entry && entry->valid;
+}
+
+size_t PageTable::getFootprintBytes() const {
+    return directory.capacity() * sizeof(directory[0]) + static_cast<size_t>(leafCount) * sizeof(Leaf);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "AtomicField.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+// Fields are atomic so the owning core can read its own entries while another core evicts one
+struct PageTableEntry {
+    AtomicField<int> frameNumber = -1;  // -1 if the page has never been given a frame
+    AtomicField<bool> valid = false;    // true if page is in physical memory
+    AtomicField<bool> dirty = false;    // optional, for write tracking
+    AtomicField<long long> lastUseTick = -1; // Tick of the last reference, for working-set estimation
+    AtomicField<bool> huge = false;     // Mapped as part of a huge page (contiguous, aligned frames)
+    AtomicField<bool> cow = false;      // Frame is shared with a fork; the next write copies it
+};
+
+// Two-level radix page table: a directory indexed by the high bits of the page number
+// points at fixed-size leaf arrays indexed by the low bits. Leaves are allocated the
+// first time a page in their range is mapped, so a lookup is two indexed loads and
+// memory grows with the pages a process touches rather than its declared size.
+// Structure changes (new leaves, directory growth) follow the page-table locking rules
+// in MemoryManager: only the owning thread makes them, with the map lock held.
+class PageTable {
+public:
+    static const int LEAF_BITS = 6;
+    static const int LEAF_SIZE = 1 << LEAF_BITS;    // Entries per leaf
+
+    PageTable() = default;
+    PageTable(const PageTable& other);
+    PageTable& operator=(const PageTable& other);
+    PageTable(PageTable&&) = default;
+    PageTable& operator=(PageTable&&) = default;
+
+    const PageTableEntry* find(int pageNumber) const;  // nullptr if the page's leaf was never allocated
+    PageTableEntry* find(int pageNumber);
+    PageTableEntry& entryFor(int pageNumber);          // Allocates the leaf on first touch
+    bool isResident(int pageNumber) const;
+
+    int getLeafCount() const { return leafCount; }
+    size_t getFootprintBytes() const;
+
+    // Visits every page that has been mapped at least once, in page order
+    template <typename Visitor>
+    void forEachMapped(Visitor&& visit) const {
+        for (size_t dir = 0; dir < directory.size(); ++dir) {
+            if (!directory[dir]) {
+                continue;
+            }
+            for (int slot = 0; slot < LEAF_SIZE; ++slot) {
+                const PageTableEntry& entry = (*directory[dir])[slot];
+                if (entry.frameNumber >= 0) {
+                    visit(static_cast<int>(dir * LEAF_SIZE + slot), entry);
+                }
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEachMapped(Visitor&& visit) {
+        for (size_t dir = 0; dir < directory.size(); ++dir) {
+            if (!directory[dir]) {
+                continue;
+            }
+            for (int slot = 0; slot < LEAF_SIZE; ++slot) {
+                PageTableEntry& entry = (*directory[dir])[slot];
+                if (entry.frameNumber >= 0) {
+                    visit(static_cast<int>(dir * LEAF_SIZE + slot), entry);
+                }
+            }
+        }
+    }
+
+private:
+    using Leaf = std::array<PageTableEntry, LEAF_SIZE>;
+
+    std::vector<std::unique_ptr<Leaf>> directory;   // directory[page >> LEAF_BITS], nullptr until touched
+    int leafCount = 0;
+};
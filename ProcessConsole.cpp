@@ -63,13 +63,18 @@ void ProcessConsole::display() {
             std::cout << "\n";
         }
         
+        std::cout << "Core Affinity: last core " << attachedProcess->getLastCore() << ", "
+                  << attachedProcess->getMigrationCount() << " migrations\n";
+
         // Show process status
         if (attachedProcess->hasFinished()) {
             std::cout << "Status: \033[1;31mFINISHED\033[0m\n\n";  // Red
         } else {
             std::cout << "Status: \033[1;33m" 
                      << (attachedProcess->getStatus() == ProcessStatus::Running ? "RUNNING" :
-                         attachedProcess->getStatus() == ProcessStatus::Waiting ? "WAITING" : "SLEEPING")
+                         attachedProcess->getStatus() == ProcessStatus::Waiting ? "WAITING" :
+                         attachedProcess->getStatus() == ProcessStatus::PageFaultWait ? "PAGE FAULT" :
+                         attachedProcess->getStatus() == ProcessStatus::Suspended ? "SUSPENDED" : "SLEEPING")
                      << "\033[0m - Line: " << (attachedProcess->getTotalInstructions() - attachedProcess->getRemainingInstructions())
                      << " / " << attachedProcess->getTotalInstructions() << "\n\n";  // Yellow status
         }
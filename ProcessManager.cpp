@@ -1,4 +1,5 @@
 #include "ProcessManager.h"
+#include "MemoryManager.h"
 #include <algorithm>
 
 ProcessManager::ProcessManager() {
@@ -19,6 +20,20 @@ void ProcessManager::removeProcess(const String& processName) {
     processMap.erase(processName);
 }
 
+std::shared_ptr<Process> ProcessManager::forkProcess(const String& sourceName, const String& childName, int childId,
+    MemoryManager& memoryManager) {
+    // Holding the process lock keeps the source off the CPU, so its registers and pages are consistent
+    std::lock_guard<std::mutex> lock(processMutex);
+    auto source = getProcessUnsafe(sourceName);
+    if (!source || source->getStatus() == ProcessStatus::Finished) {
+        return nullptr;
+    }
+
+    auto child = std::make_shared<Process>(*source, childName, childId);
+    memoryManager.forkAddressSpace(source.get(), child.get());
+    return child;
+}
+
 bool ProcessManager::hasProcess(const String& processName) const {
     std::lock_guard<std::mutex> lock(processMutex);
     return processMap.find(processName) != processMap.end();
@@ -30,8 +45,9 @@ void ProcessManager::updateProcessStatus(const String& processName, ProcessStatu
     if (process) {
         process->setStatus(status);
         
-        // Ensure consistency: if setting to Waiting or Sleeping, core should be -1
-        if (status == ProcessStatus::Waiting || status == ProcessStatus::Sleeping) {
+        // Ensure consistency: if the process is not running, core should be -1
+        if (status == ProcessStatus::Waiting || status == ProcessStatus::Sleeping ||
+            status == ProcessStatus::PageFaultWait || status == ProcessStatus::Suspended) {
             process->setAssignedCore(-1);
         }
     }
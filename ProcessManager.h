@@ -6,6 +6,8 @@
 #include <mutex>
 #include <vector>
 
+class MemoryManager;
+
 class ProcessManager {
 public:
     ProcessManager();
@@ -15,6 +17,9 @@ public:
     void addProcess(std::shared_ptr<Process> process);
     void removeProcess(const String& processName);
     bool hasProcess(const String& processName) const;
+    // Clones the source between instructions; the child is not added (nullptr if the source is missing or finished)
+    std::shared_ptr<Process> forkProcess(const String& sourceName, const String& childName, int childId,
+        MemoryManager& memoryManager);
     
     // Process state management
     void updateProcessStatus(const String& processName, ProcessStatus status);
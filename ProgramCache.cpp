@@ -0,0 +1,355 @@
+#include "ProgramCache.h"
+#include "Config.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    std::mutex g_cacheMutex;
+    std::unordered_map<String, std::weak_ptr<const ProgramImage>> g_images; // Key -> image, expired once unused
+    size_t g_sweepThreshold = 64;   // Expired keys are dropped when the map grows past this
+    int g_hitCount = 0;
+    int g_missCount = 0;
+
+    Instruction makeGreeting() {
+        Instruction instr(InstructionType::PRINT);
+        instr.arg2 = "GREETING";
+        return instr;
+    }
+
+    size_t measure(const ProgramImage& image) {
+        size_t bytes = sizeof(ProgramImage) + image.instructions.capacity() * sizeof(Instruction);
+        for (const auto& instr : image.instructions) {
+            bytes += instr.arg1.capacity() + instr.arg2.capacity() + instr.arg3.capacity();
+        }
+        return bytes;
+    }
+}
+
+std::shared_ptr<const ProgramImage> ProgramCache::intern(const String& key,
+    const std::function<std::shared_ptr<ProgramImage>()>& build) {
+    {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto it = g_images.find(key);
+        if (it != g_images.end()) {
+            if (auto image = it->second.lock()) {
+                g_hitCount++;
+                return image;
+            }
+        }
+    }
+
+    std::shared_ptr<ProgramImage> built = build();
+    built->hostBytes = measure(*built);
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    // Another thread may have published the same program while this one was building
+    auto& slot = g_images[key];
+    if (auto image = slot.lock()) {
+        g_hitCount++;
+        return image;
+    }
+    std::shared_ptr<const ProgramImage> image = std::move(built);
+    slot = image;
+    g_missCount++;
+
+    if (g_images.size() > g_sweepThreshold) {
+        for (auto it = g_images.begin(); it != g_images.end();) {
+            it = it->second.expired() ? g_images.erase(it) : std::next(it);
+        }
+        g_sweepThreshold = std::max<size_t>(64, g_images.size() * 2);
+    }
+    return image;
+}
+
+std::shared_ptr<const ProgramImage> ProgramCache::parse(const String& text, int paddedLength) {
+    return intern("text:" + std::to_string(paddedLength) + ":" + text, [&]() {
+        auto image = std::make_shared<ProgramImage>();
+        std::vector<Instruction>& instructions = image->instructions;
+        std::vector<std::string> instructionList;
+
+        // Split by semicolons
+        size_t pos = 0;
+        std::string input = text;
+        while ((pos = input.find(';')) != std::string::npos) {
+            std::string instr = input.substr(0, pos);
+            instructionList.push_back(instr);
+            input.erase(0, pos + 1);
+        }
+        if (!input.empty()) {
+            instructionList.push_back(input);
+        }
+
+        // TOBEDELETED: Validate instruction count - MO2 spec requires exact error message
+        if (instructionList.empty() || instructionList.size() > 50) {
+            // TOBEDELETED: MO2 specification: "Throws 'invalid command' if the instruction size is not met"
+            throw std::runtime_error("invalid command");
+        }
+
+        // Parse each instruction
+        for (const auto& instrText : instructionList) {
+            std::string trimmed = instrText;
+            trimmed.erase(0, trimmed.find_first_not_of(" \t\r\n"));
+            trimmed.erase(trimmed.find_last_not_of(" \t\r\n") + 1);
+
+            std::stringstream ss(trimmed);
+            std::string cmd;
+            ss >> cmd;
+
+            if (cmd == "DECLARE") {
+                std::string varName;
+                uint16_t value;
+                ss >> varName >> value;
+
+                Instruction instr(InstructionType::DECLARE);
+                instr.arg1 = varName;
+                instr.value = value;
+                instructions.push_back(instr);
+            }
+            else if (cmd == "ADD") {
+                std::string result, op1, op2;
+                ss >> result >> op1 >> op2;
+
+                Instruction instr(InstructionType::ADD);
+                instr.arg1 = result;
+                instr.arg2 = op1;
+                instr.arg3 = op2;
+                instructions.push_back(instr);
+            }
+            else if (cmd == "SUBTRACT") {
+                std::string result, op1, op2;
+                ss >> result >> op1 >> op2;
+
+                Instruction instr(InstructionType::SUBTRACT);
+                instr.arg1 = result;
+                instr.arg2 = op1;
+                instr.arg3 = op2;
+                instructions.push_back(instr);
+            }
+            else if (cmd == "WRITE") {
+                std::string address, value;
+                ss >> address >> value;
+
+                Instruction instr(InstructionType::WRITE);
+                instr.arg1 = address;
+
+                // Check if value is a variable or literal
+                if (!value.empty() && std::isdigit(value[0])) {
+                    instr.value = static_cast<uint16_t>(std::stoi(value));
+                } else {
+                    instr.arg2 = value; // It's a variable name
+                }
+                instructions.push_back(instr);
+            }
+            else if (cmd == "READ") {
+                std::string varName, address;
+                ss >> varName >> address;
+
+                Instruction instr(InstructionType::READ);
+                instr.arg1 = varName;
+                instr.arg2 = address;
+                instructions.push_back(instr);
+            }
+            else if (trimmed.find("PRINT") == 0) {
+                // TOBEDELETED: Handle PRINT with string literals and expressions
+                size_t openParen = trimmed.find("(");
+                size_t closeParen = trimmed.find_last_of(")");
+
+                if (openParen != std::string::npos && closeParen != std::string::npos) {
+                    std::string content = trimmed.substr(openParen + 1, closeParen - openParen - 1);
+
+                    Instruction instr(InstructionType::PRINT);
+                    instr.arg1 = content;
+
+                    // TOBEDELETED: Check if this is a string concatenation expression (contains + operator)
+                    if (content.find(" + ") != std::string::npos) {
+                        instr.arg2 = "EXPRESSION"; // TOBEDELETED: Flag for expression evaluation
+                    }
+
+                    instructions.push_back(instr);
+                }
+            }
+            else if (cmd == "SLEEP") {
+                uint16_t cycles;
+                ss >> cycles;
+
+                Instruction instr(InstructionType::SLEEP);
+                instr.value = cycles;
+                instructions.push_back(instr);
+            }
+        }
+
+        image->lineCount = static_cast<int>(instructions.size());
+
+        // Fill any remaining slots with PRINT instructions if needed
+        while (static_cast<int>(instructions.size()) < paddedLength) {
+            instructions.push_back(makeGreeting());
+        }
+        return image;
+    });
+}
+
+std::shared_ptr<const ProgramImage> ProgramCache::generate(uint32_t seed, int numInstructions, int memorySize) {
+    std::ostringstream key;
+    key << "gen:" << seed << ":" << numInstructions << ":" << memorySize;
+    return intern(key.str(), [&]() {
+        auto image = std::make_shared<ProgramImage>();
+        std::vector<Instruction>& instructions = image->instructions;
+        int totalInstructions = numInstructions;
+
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<> instrTypeDist(0, 8); // Now 9 instruction types
+        std::uniform_int_distribution<> valueDist(1, 100);
+        std::uniform_int_distribution<> forRepeatsDist(2, 5);
+        std::uniform_int_distribution<> sleepDist(1, 10);
+
+        static const std::vector<std::string> varNames = {"x", "y", "z", "a", "b", "c", "counter", "temp", "result", "sum"};
+        std::uniform_int_distribution<> varDist(0, static_cast<int>(varNames.size()) - 1);
+        auto randomVariableName = [&]() { return varNames[varDist(gen)]; };
+
+        instructions.reserve(totalInstructions); // Reserve full space including potential FOR_ENDs
+
+        // Leave room to close the deepest FOR nesting
+        int maxForLoops = 3;
+        int instructionsToGenerate = numInstructions - maxForLoops;
+        int forNestingLevel = 0;
+        std::vector<int> forStartPositions;
+        std::vector<std::string> declaredVariables;
+
+        for (int i = 0; i < instructionsToGenerate && static_cast<int>(instructions.size()) < totalInstructions; i++) { // TOBEDELETED: Fix C4018 warning
+            InstructionType instrType = static_cast<InstructionType>(instrTypeDist(gen));
+
+            // Limit FOR loop nesting to 3 levels and prevent new FOR loops if close to instruction limit
+            if (instrType == InstructionType::FOR_START &&
+                (forNestingLevel >= 3 || static_cast<int>(instructions.size()) >= totalInstructions - static_cast<int>(forStartPositions.size()))) { // TOBEDELETED: Fix C4018 warning
+                instrType = InstructionType::PRINT; // Default to PRINT instead
+            }
+
+            Instruction instr(instrType);
+
+            switch (instrType) {
+                case InstructionType::PRINT: {
+                    // Generate PRINT with variable or simple message
+                    if (declaredVariables.empty() || valueDist(gen) % 2 == 0) {
+                        instr = makeGreeting();
+                    } else {
+                        // Print a variable
+                        instr.arg1 = "Value from: " + declaredVariables[valueDist(gen) % declaredVariables.size()];
+                    }
+                    break;
+                }
+                case InstructionType::DECLARE: {
+                    instr.arg1 = randomVariableName();
+                    instr.value = valueDist(gen);
+                    declaredVariables.push_back(instr.arg1);
+                    break;
+                }
+                case InstructionType::ADD:
+                case InstructionType::SUBTRACT: {
+                    instr.arg1 = randomVariableName(); // Result variable
+                    instr.arg2 = randomVariableName(); // First operand
+                    if (valueDist(gen) % 2 == 0) {
+                        instr.arg3 = randomVariableName(); // Variable operand
+                    } else {
+                        instr.value = valueDist(gen); // Numeric operand
+                    }
+                    break;
+                }
+                case InstructionType::SLEEP: {
+                    instr.value = sleepDist(gen);
+                    break;
+                }
+                case InstructionType::FOR_START: {
+                    instr.value = forRepeatsDist(gen);
+                    instr.forLevel = forNestingLevel;
+                    forStartPositions.push_back(i);
+                    forNestingLevel++;
+                    break;
+                }
+                case InstructionType::FOR_END: {
+                    if (!forStartPositions.empty()) {
+                        forNestingLevel--;
+                        instr.forLevel = forNestingLevel;
+                        forStartPositions.pop_back();
+                    } else {
+                        // No matching FOR_START, convert to PRINT
+                        instr = makeGreeting();
+                    }
+                    break;
+                }
+                case InstructionType::READ: {
+                    instr.arg1 = randomVariableName(); // Variable to store result
+                    std::ostringstream addressStream;
+                    addressStream << "0x" << std::hex << (gen() % static_cast<uint32_t>(memorySize));
+                    instr.arg2 = addressStream.str();
+                    break;
+                }
+                case InstructionType::WRITE: {
+                    std::ostringstream addressStream;
+                    addressStream << "0x" << std::hex << (gen() % static_cast<uint32_t>(memorySize));
+                    instr.arg1 = addressStream.str();
+                    instr.value = valueDist(gen); // Random value to write
+                    break;
+                }
+            }
+
+            instructions.push_back(instr);
+        }
+
+        // Close any unclosed FOR loops, but only if we have space
+        while (!forStartPositions.empty() && static_cast<int>(instructions.size()) < totalInstructions) { // TOBEDELETED: Fix C4018 warning
+            Instruction endInstr(InstructionType::FOR_END);
+            endInstr.forLevel = --forNestingLevel;
+            instructions.push_back(endInstr);
+            forStartPositions.pop_back();
+        }
+
+        // Fill any remaining slots with PRINT instructions
+        while (static_cast<int>(instructions.size()) < totalInstructions) { // TOBEDELETED: Fix C4018 warning
+            instructions.push_back(makeGreeting());
+        }
+        image->lineCount = static_cast<int>(instructions.size());
+        return image;
+    });
+}
+
+int ProgramCache::pickSeed() {
+    std::random_device rd;
+    int variants = Config::getProgramVariants();
+    return static_cast<int>(variants > 0 ? rd() % static_cast<uint32_t>(variants) : rd() >> 1);
+}
+
+int ProgramCache::getImageCount() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    int count = 0;
+    for (const auto& [key, image] : g_images) {
+        count += image.expired() ? 0 : 1;
+    }
+    return count;
+}
+
+size_t ProgramCache::getImageBytes() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    size_t bytes = 0;
+    for (const auto& [key, weak] : g_images) {
+        if (auto image = weak.lock()) {
+            bytes += image->hostBytes;
+        }
+    }
+    return bytes;
+}
+
+int ProgramCache::getHitCount() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    return g_hitCount;
+}
+
+int ProgramCache::getMissCount() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    return g_missCount;
+}
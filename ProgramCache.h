@@ -0,0 +1,65 @@
+#pragma once
+#include "TypedefRepo.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Instruction types for the process programming language
+enum class InstructionType {
+    PRINT,
+    DECLARE,
+    ADD,
+    SUBTRACT,
+    SLEEP,
+    FOR_START,
+    FOR_END,
+    READ,
+    WRITE
+};
+
+
+// Individual instruction structure
+struct Instruction {
+    InstructionType type;
+    std::string arg1;       // Variable name, message, or operand
+    std::string arg2;       // Second operand (for ADD/SUBTRACT)
+    std::string arg3;       // Third operand (for ADD/SUBTRACT)
+    uint16_t value;         // Numeric value (for DECLARE, SLEEP, FOR repeats)
+    int forLevel;           // Nesting level for FOR loops (0-2)
+
+    Instruction(InstructionType t) : type(t), value(0), forLevel(0) {}
+};
+
+// Decoded program shared read-only by every process running the same code. Nothing in it
+// depends on the process: greetings are PRINTs flagged "GREETING" that add the name when run.
+struct ProgramImage {
+    std::vector<Instruction> instructions;
+    int lineCount = 0;      // Instructions a process executes; custom programs are padded past it
+    size_t hostBytes = 0;   // Approximate host memory held by the image
+};
+
+// Content-addressed cache of program images. Identical instruction text, or the same
+// generator seed and parameters, decode once; later processes get the same image. The
+// cache holds weak references, so an image is freed with the last process using it.
+// All functions are thread-safe.
+class ProgramCache {
+public:
+    // Throws std::runtime_error("invalid command") for an empty or over-long program
+    static std::shared_ptr<const ProgramImage> parse(const String& text, int paddedLength);
+    static std::shared_ptr<const ProgramImage> generate(uint32_t seed, int numInstructions, int memorySize);
+    // One of program-variants seeds, or a fresh one when variants are off; never negative. The key
+    // includes the length and memory size, so callers roll both from the seed to share an image
+    static int pickSeed();
+
+    // Statistics
+    static int getImageCount();         // Images still referenced by a process
+    static size_t getImageBytes();
+    static int getHitCount();           // Requests served by an existing image
+    static int getMissCount();
+
+private:
+    // Looks the key up, building and publishing a new image on a miss; build runs unlocked
+    static std::shared_ptr<const ProgramImage> intern(const String& key,
+        const std::function<std::shared_ptr<ProgramImage>()>& build);
+};
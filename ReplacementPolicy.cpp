@@ -0,0 +1,268 @@
+#include "ReplacementPolicy.h"
+#include "MemoryManager.h"
+#include "process.h"
+#include <algorithm>
+#include <iostream>
+
+std::unique_ptr<ReplacementPolicy> ReplacementPolicy::create(const String& name, int numFrames) {
+    if (name == "lru") return std::make_unique<LRUPolicy>(numFrames);
+    if (name == "wsclock") return std::make_unique<WSClockPolicy>(numFrames);
+    if (name == "2q") return std::make_unique<TwoQueuePolicy>(numFrames);
+    if (name == "arc") return std::make_unique<ARCPolicy>(numFrames);
+
+    if (name != "clock") {
+        std::cout << "Warning: Unknown page-replacement policy '" << name << "'. Using clock." << std::endl;
+    }
+    return std::make_unique<ClockPolicy>();
+}
+
+uint64_t ReplacementPolicy::makePageKey(int processId, int pageNumber) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(processId)) << 32) | static_cast<uint32_t>(pageNumber);
+}
+
+// CLOCK ALGORITHM: sweep from the hand, clearing reference bits, until an unreferenced frame turns up
+int ClockPolicy::selectVictim(std::vector<FrameInfo>& frames) {
+    int numFrames = static_cast<int>(frames.size());
+    while (true) {
+        FrameInfo& frame = frames[clockHand];
+        int candidate = clockHand;
+        clockHand = (clockHand + 1) % numFrames;
+
+        if (!frame.referenced) {
+            return candidate;
+        }
+
+        // Give second chance
+        frame.referenced = false;
+    }
+}
+
+LRUPolicy::LRUPolicy(int numFrames)
+    : position(numFrames), tracked(numFrames, false) {
+}
+
+void LRUPolicy::onMap(int frameNumber, uint64_t /*pageKey*/) {
+    recency.push_front(frameNumber);
+    position[frameNumber] = recency.begin();
+    tracked[frameNumber] = true;
+}
+
+void LRUPolicy::onAccess(int frameNumber) {
+    if (tracked[frameNumber]) {
+        recency.splice(recency.begin(), recency, position[frameNumber]);
+    }
+}
+
+void LRUPolicy::onUnmap(int frameNumber) {
+    if (tracked[frameNumber]) {
+        recency.erase(position[frameNumber]);
+        tracked[frameNumber] = false;
+    }
+}
+
+int LRUPolicy::selectVictim(std::vector<FrameInfo>& /*frames*/) {
+    return recency.back();
+}
+
+WSClockPolicy::WSClockPolicy(int numFrames)
+    : window(static_cast<long long>(std::max(numFrames, 1)) * WINDOW_FRAMES), lastUse(numFrames, 0) {
+}
+
+void WSClockPolicy::onMap(int frameNumber, uint64_t /*pageKey*/) {
+    lastUse[frameNumber] = ++virtualTime;
+}
+
+void WSClockPolicy::onAccess(int frameNumber) {
+    lastUse[frameNumber] = ++virtualTime;
+}
+
+int WSClockPolicy::selectVictim(std::vector<FrameInfo>& frames) {
+    int numFrames = static_cast<int>(frames.size());
+    int oldestDirty = -1;
+    int oldest = clockHand;
+
+    // One full sweep: referenced frames are in the working set and get their bit cleared;
+    // the first clean frame idle past the window is taken
+    for (int step = 0; step < numFrames; ++step) {
+        int candidate = clockHand;
+        FrameInfo& frame = frames[candidate];
+        clockHand = (clockHand + 1) % numFrames;
+
+        if (frame.referenced) {
+            frame.referenced = false;
+            lastUse[candidate] = virtualTime;
+            continue;
+        }
+        if (lastUse[candidate] < lastUse[oldest]) {
+            oldest = candidate;
+        }
+        if (virtualTime - lastUse[candidate] <= window) {
+            continue;
+        }
+
+        bool dirty = false;
+        if (frame.owner) {
+            const PageTableEntry* entry = frame.owner->getPageTable().find(frame.pageNumber);
+            dirty = entry && entry->dirty;
+        }
+        if (!dirty) {
+            return candidate;
+        }
+        if (oldestDirty < 0) {
+            oldestDirty = candidate;
+        }
+    }
+
+    // Every old page is dirty, or the whole set is in use: fall back to the stalest page
+    return oldestDirty >= 0 ? oldestDirty : oldest;
+}
+
+TwoQueuePolicy::TwoQueuePolicy(int numFrames)
+    : inLimit(std::max<size_t>(1, numFrames / 4)), ghostLimit(std::max<size_t>(1, numFrames / 2)),
+      queueOf(numFrames, None), position(numFrames), frameKey(numFrames, 0) {
+}
+
+void TwoQueuePolicy::onFault(uint64_t pageKey) {
+    auto ghost = ghostIndex.find(pageKey);
+    pendingGhostHit = ghost != ghostIndex.end();
+    if (pendingGhostHit) {
+        a1out.erase(ghost->second);
+        ghostIndex.erase(ghost);
+    }
+}
+
+void TwoQueuePolicy::onMap(int frameNumber, uint64_t pageKey) {
+    std::list<int>& queue = pendingGhostHit ? am : a1in;
+    queue.push_front(frameNumber);
+    position[frameNumber] = queue.begin();
+    queueOf[frameNumber] = pendingGhostHit ? Am : A1in;
+    frameKey[frameNumber] = pageKey;
+    pendingGhostHit = false;
+}
+
+void TwoQueuePolicy::onAccess(int frameNumber) {
+    // Hits in A1in are deliberately ignored: correlated references right after the fault don't count
+    if (queueOf[frameNumber] == Am) {
+        am.splice(am.begin(), am, position[frameNumber]);
+    }
+}
+
+void TwoQueuePolicy::onUnmap(int frameNumber) {
+    if (queueOf[frameNumber] == A1in) {
+        a1in.erase(position[frameNumber]);
+
+        // Remember the page so a re-fault soon after proves it is hot
+        uint64_t key = frameKey[frameNumber];
+        a1out.push_front(key);
+        ghostIndex[key] = a1out.begin();
+        if (a1out.size() > ghostLimit) {
+            ghostIndex.erase(a1out.back());
+            a1out.pop_back();
+        }
+    }
+    else if (queueOf[frameNumber] == Am) {
+        am.erase(position[frameNumber]);
+    }
+    queueOf[frameNumber] = None;
+}
+
+int TwoQueuePolicy::selectVictim(std::vector<FrameInfo>& /*frames*/) {
+    if (!a1in.empty() && (a1in.size() > inLimit || am.empty())) {
+        return a1in.back();
+    }
+    return am.back();
+}
+
+bool ARCPolicy::GhostList::erase(uint64_t key) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return false;
+    }
+    keys.erase(it->second);
+    index.erase(it);
+    return true;
+}
+
+void ARCPolicy::GhostList::pushFront(uint64_t key) {
+    keys.push_front(key);
+    index[key] = keys.begin();
+}
+
+void ARCPolicy::GhostList::trim(size_t limit) {
+    while (keys.size() > limit) {
+        index.erase(keys.back());
+        keys.pop_back();
+    }
+}
+
+ARCPolicy::ARCPolicy(int numFrames)
+    : capacity(numFrames), listOf(numFrames, None), position(numFrames),
+      frameKey(numFrames, 0), freshlyMapped(numFrames, false) {
+}
+
+void ARCPolicy::onFault(uint64_t pageKey) {
+    // A ghost hit means the list it was evicted from was too small: shift the target toward it
+    if (b1.erase(pageKey)) {
+        size_t delta = std::max<size_t>(1, b2.size() / std::max<size_t>(1, b1.size()));
+        targetT1 = std::min(capacity, targetT1 + delta);
+        pendingHit = HitB1;
+    }
+    else if (b2.erase(pageKey)) {
+        size_t delta = std::max<size_t>(1, b1.size() / std::max<size_t>(1, b2.size()));
+        targetT1 = targetT1 > delta ? targetT1 - delta : 0;
+        pendingHit = HitB2;
+    }
+    else {
+        pendingHit = NoHit;
+    }
+}
+
+void ARCPolicy::onMap(int frameNumber, uint64_t pageKey) {
+    // New pages start in T1; pages remembered by a ghost list have been seen twice and go to T2
+    std::list<int>& target = pendingHit == NoHit ? t1 : t2;
+    target.push_front(frameNumber);
+    position[frameNumber] = target.begin();
+    listOf[frameNumber] = pendingHit == NoHit ? T1 : T2;
+    frameKey[frameNumber] = pageKey;
+    freshlyMapped[frameNumber] = true;
+    pendingHit = NoHit;
+}
+
+void ARCPolicy::onAccess(int frameNumber) {
+    if (freshlyMapped[frameNumber]) {
+        freshlyMapped[frameNumber] = false;
+        return;
+    }
+    if (listOf[frameNumber] == T1) {
+        t2.splice(t2.begin(), t1, position[frameNumber]);
+        listOf[frameNumber] = T2;
+    }
+    else if (listOf[frameNumber] == T2) {
+        t2.splice(t2.begin(), t2, position[frameNumber]);
+    }
+}
+
+void ARCPolicy::onUnmap(int frameNumber) {
+    uint64_t key = frameKey[frameNumber];
+    if (listOf[frameNumber] == T1) {
+        t1.erase(position[frameNumber]);
+        b1.pushFront(key);
+    }
+    else if (listOf[frameNumber] == T2) {
+        t2.erase(position[frameNumber]);
+        b2.pushFront(key);
+    }
+    listOf[frameNumber] = None;
+    freshlyMapped[frameNumber] = false;
+
+    // Ghosts never outnumber the cache: |T1| + |B1| <= c and the whole directory stays within 2c
+    b1.trim(capacity > t1.size() ? capacity - t1.size() : 0);
+    b2.trim(2 * capacity - std::min(2 * capacity, t1.size() + t2.size() + b1.size()));
+}
+
+int ARCPolicy::selectVictim(std::vector<FrameInfo>& /*frames*/) {
+    // REPLACE(p): take from T1 while it is over its target, otherwise from T2
+    bool fromT1 = !t1.empty() &&
+        (t1.size() > targetT1 || (pendingHit == HitB2 && t1.size() == targetT1) || t2.empty());
+    return fromT1 ? t1.back() : t2.back();
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "TypedefRepo.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct FrameInfo;
+
+// Victim selection for demand paging. MemoryManager reports every fault, mapping,
+// access and eviction; when no frame is free the policy names the one to evict.
+// Every hook is called with MemoryManager's map lock held.
+// Selected by the page-replacement config key (clock, lru, wsclock, 2q, arc).
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() = default;
+
+    static std::unique_ptr<ReplacementPolicy> create(const String& name, int numFrames);
+    static uint64_t makePageKey(int processId, int pageNumber);
+
+    virtual const char* getName() const = 0;
+    virtual bool tracksAccesses() const { return false; }     // onAccess does work (costs a lock per reference)
+
+    virtual void onFault(uint64_t /*pageKey*/) {}                     // Page is missing; called before any victim is chosen
+    virtual void onMap(int /*frameNumber*/, uint64_t /*pageKey*/) {}  // Page is now resident in frameNumber
+    virtual void onAccess(int /*frameNumber*/) {}                     // Resident page was touched
+    virtual void onUnmap(int /*frameNumber*/) {}                      // Page in frameNumber was evicted
+    virtual int selectVictim(std::vector<FrameInfo>& frames) = 0;
+};
+
+// Second-chance clock over the frame table's reference bits
+class ClockPolicy : public ReplacementPolicy {
+public:
+    const char* getName() const override { return "clock"; }
+    int selectVictim(std::vector<FrameInfo>& frames) override;
+
+private:
+    int clockHand = 0;  // Points to next frame to consider for replacement
+};
+
+// Exact LRU: every access moves the frame to the front of a recency list
+class LRUPolicy : public ReplacementPolicy {
+public:
+    explicit LRUPolicy(int numFrames);
+    const char* getName() const override { return "lru"; }
+    bool tracksAccesses() const override { return true; }
+
+    void onMap(int frameNumber, uint64_t pageKey) override;
+    void onAccess(int frameNumber) override;
+    void onUnmap(int frameNumber) override;
+    int selectVictim(std::vector<FrameInfo>& frames) override;
+
+private:
+    std::list<int> recency;                         // Most recently used at the front
+    std::vector<std::list<int>::iterator> position;
+    std::vector<bool> tracked;
+};
+
+// WSClock: clock sweep that evicts pages idle for longer than the working-set window,
+// preferring clean ones so an eviction does not cost a writeback
+class WSClockPolicy : public ReplacementPolicy {
+public:
+    explicit WSClockPolicy(int numFrames);
+    const char* getName() const override { return "wsclock"; }
+    bool tracksAccesses() const override { return true; }
+
+    void onMap(int frameNumber, uint64_t pageKey) override;
+    void onAccess(int frameNumber) override;
+    int selectVictim(std::vector<FrameInfo>& frames) override;
+
+private:
+    static const int WINDOW_FRAMES = 4;  // Window in accesses, as a multiple of the frame count
+
+    int clockHand = 0;
+    long long virtualTime = 0;           // Advances once per access
+    long long window;
+    std::vector<long long> lastUse;
+};
+
+// 2Q: first-touch pages wait in a FIFO (A1in); only pages re-faulted while remembered
+// in the ghost queue (A1out) are promoted to the LRU main queue (Am), so scans can't flush it
+class TwoQueuePolicy : public ReplacementPolicy {
+public:
+    explicit TwoQueuePolicy(int numFrames);
+    const char* getName() const override { return "2q"; }
+    bool tracksAccesses() const override { return true; }
+
+    void onFault(uint64_t pageKey) override;
+    void onMap(int frameNumber, uint64_t pageKey) override;
+    void onAccess(int frameNumber) override;
+    void onUnmap(int frameNumber) override;
+    int selectVictim(std::vector<FrameInfo>& frames) override;
+
+private:
+    enum Queue : uint8_t { None, A1in, Am };
+
+    size_t inLimit;                 // Kin: A1in size before it is preferred for eviction
+    size_t ghostLimit;              // Kout: pages remembered in A1out
+    bool pendingGhostHit = false;   // Faulting page was found in A1out
+
+    std::list<int> a1in;            // Newest at the front
+    std::list<int> am;              // Most recently used at the front
+    std::list<uint64_t> a1out;      // Newest ghost at the front
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> ghostIndex;
+
+    std::vector<Queue> queueOf;
+    std::vector<std::list<int>::iterator> position;
+    std::vector<uint64_t> frameKey;
+};
+
+// ARC: balances a recency list (T1) against a frequency list (T2), steering the target
+// size of T1 by hits in the ghost lists of pages recently evicted from each (B1, B2)
+class ARCPolicy : public ReplacementPolicy {
+public:
+    explicit ARCPolicy(int numFrames);
+    const char* getName() const override { return "arc"; }
+    bool tracksAccesses() const override { return true; }
+
+    void onFault(uint64_t pageKey) override;
+    void onMap(int frameNumber, uint64_t pageKey) override;
+    void onAccess(int frameNumber) override;
+    void onUnmap(int frameNumber) override;
+    int selectVictim(std::vector<FrameInfo>& frames) override;
+
+private:
+    enum List : uint8_t { None, T1, T2 };
+    enum GhostHit : uint8_t { NoHit, HitB1, HitB2 };
+
+    struct GhostList {
+        std::list<uint64_t> keys;   // Most recent at the front
+        std::unordered_map<uint64_t, std::list<uint64_t>::iterator> index;
+
+        bool erase(uint64_t key);
+        void pushFront(uint64_t key);
+        void trim(size_t limit);
+        size_t size() const { return keys.size(); }
+    };
+
+    size_t capacity;
+    size_t targetT1 = 0;            // ARC's p
+    GhostHit pendingHit = NoHit;
+
+    std::list<int> t1, t2;          // Most recently used at the front
+    GhostList b1, b2;
+
+    std::vector<List> listOf;
+    std::vector<std::list<int>::iterator> position;
+    std::vector<uint64_t> frameKey;
+    std::vector<bool> freshlyMapped; // The access that faulted a page in is not a second reference
+};
@@ -1,5 +1,7 @@
 ﻿#include "Scheduler.h"
 #include "Config.h"
+#include <algorithm>
+#include <cstdlib>
 #include <random>
 #include <sstream>
 #include <iomanip>
@@ -9,6 +11,7 @@
 CPUScheduler::CPUScheduler() 
     : processManager(),
       coreManager(Config::getNumCpu()),
+      runQueues(Config::getRunQueues() == "per-core" ? std::max(1, Config::getNumCpu()) : 1),
       schedulerRunning(false), 
       generatorRunning(false), 
       cpuTicks(0), 
@@ -90,25 +93,18 @@ void CPUScheduler::addProcess(std::shared_ptr<Process> process) {
     // Set the memory manager reference in the process
     process->setMemoryManager(&memoryManager);
 
-    // Convert to unordered_map and update MemoryManager
-    std::unordered_map<String, std::shared_ptr<Process>> map;
-    for (const auto& pname : processManager.getAllProcessNames()) {
-        auto p = processManager.getProcess(pname);
-        if (p) map[pname] = p;
+    // Let MemoryManager resolve the process by name for block allocation
+    memoryManager.registerProcess(process);
+
+    // A fork of a sleeping process sleeps out the parent's remaining cycles before it is ready
+    if (process->getStatus() == ProcessStatus::Sleeping) {
+        return;
     }
-    memoryManager.setProcessMap(map);
 
     // Add to appropriate queue
     {
         std::lock_guard<std::mutex> queueLock(queueMutex);
-        String algorithm = Config::getScheduler();
-
-        if (algorithm == "fcfs") {
-            fcfsQueue.push(name);
-        }
-        else if (algorithm == "rr") {
-            roundRobinQueue.push_back(name);
-        }
+        enqueueReady(name);
     }
 
     process->setStatus(ProcessStatus::Waiting);
@@ -154,11 +150,26 @@ void CPUScheduler::onCpuTick() {
     // Phase 2: Handle sleeping processes (decrement sleep counters)
     handleSleepingProcesses();
     
+    // Phase 2b: Let the pager finish blocked page faults and requeue their processes
+    handlePageFaults();
+    
+    // Phase 2c: Load control - swap processes out while their working sets overflow memory
+    handleLoadControl();
+
+    // Phase 2d: Same-page merging, a bounded number of frames per tick
+    memoryManager.scanForDuplicatePages();
+    
     // Phase 3: Handle completed processes
     handleProcessCompletion();
     
     // Phase 4: Handle quantum expiration (Round Robin)
     handleQuantumExpiration();
+
+    // Phase 4b: Medium-term scheduling - swap whole processes in, or out for one blocked on memory
+    handleSwapping();
+
+    // Phase 4c: Periodically move queued work from the busiest core's run queue to the idlest
+    handleLoadBalancing();
     
     // Phase 5: Schedule new processes to available cores
     scheduleWaitingProcesses();
@@ -176,6 +187,16 @@ void CPUScheduler::handleProcessExecution() {
     // Get all currently running processes
     auto runningProcesses = coreManager.getNonEmptyAssignments();
 
+    // A process that just migrated spends its first ticks refilling the new core's cache instead of executing
+    runningProcesses.erase(std::remove_if(runningProcesses.begin(), runningProcesses.end(), [this](const String& name) {
+        auto process = processManager.getProcess(name);
+        if (process && process->consumeWarmupTick()) {
+            warmupStallTicks++;
+            return true;
+        }
+        return false;
+        }), runningProcesses.end());
+
     // Execute one instruction for each running process
     auto results = processManager.executeInstructionsForProcesses(runningProcesses);
 
@@ -200,11 +221,17 @@ void CPUScheduler::handleProcessExecution() {
                 }
             }
             // Return to ready queue (optional depending on scheduler)
-            if (Config::getScheduler() == "fcfs") {
-                fcfsQueue.push(result.name);
-            }
-            else if (Config::getScheduler() == "rr") {
-                roundRobinQueue.push_back(result.name);
+            std::lock_guard<std::mutex> queueLock(queueMutex);
+            enqueueReady(result.name);
+        }
+        else if (result.process && result.process->getStatus() == ProcessStatus::PageFaultWait) {
+            // Release the core; the pager requeues the process once its pages are resident
+            for (int coreId = 0; coreId < coreManager.getCoreCount(); coreId++) {
+                if (coreManager.getAssignment(coreId) == result.name) {
+                    coreManager.clearAssignment(coreId);
+                    processManager.setProcessCore(result.name, -1);
+                    break;
+                }
             }
         }
     }
@@ -224,18 +251,170 @@ void CPUScheduler::handleSleepingProcesses() {
             // If sleep finished, add back to waiting queue
             if (process->getStatus() == ProcessStatus::Waiting) {
                 std::lock_guard<std::mutex> queueLock(queueMutex);
-                String algorithm = Config::getScheduler();
-                
-                if (algorithm == "fcfs") {
-                    fcfsQueue.push(processName);
-                } else if (algorithm == "rr") {
-                    roundRobinQueue.push_back(processName);
-                }
+                enqueueReady(processName);
             }
         }
     }
 }
 
+void CPUScheduler::handlePageFaults() {
+    auto resumedProcesses = memoryManager.servicePageFaults(cpuTicks.load());
+    if (resumedProcesses.empty()) return;
+
+    std::lock_guard<std::mutex> queueLock(queueMutex);
+    for (Process* process : resumedProcesses) {
+        if (process->getStatus() != ProcessStatus::PageFaultWait) {
+            continue;
+        }
+        processManager.updateProcessStatus(process->getName(), ProcessStatus::Waiting);
+
+        enqueueReady(process->getName());
+    }
+}
+
+void CPUScheduler::handleLoadControl() {
+    int window = Config::getWorkingSetWindow();
+    if (window <= 0) return;
+    int interval = std::max(1, window / 4);
+    if (cpuTicks.load() % interval != 0) return;
+
+    // Working sets count shared code once per process, so an over-full sum alone is not thrashing;
+    // the processes must also be faulting, on average at least once a tick since the last pass
+    int faults = memoryManager.getFaultCount();
+    bool thrashing = faults - loadControlFaults >= interval;
+    loadControlFaults = faults;
+
+    // Sum the working sets of every process still competing for frames
+    int frames = memoryManager.getTotalFrames();
+    int total = 0;
+    int active = 0;
+    std::vector<std::pair<std::shared_ptr<Process>, int>> candidates;
+    for (const auto& [name, process] : processManager.getAllProcesses()) {
+        ProcessStatus status = process->getStatus();
+        if (status == ProcessStatus::Finished || status == ProcessStatus::Suspended) {
+            continue;
+        }
+        int workingSet = memoryManager.getWorkingSetSize(process.get(), window);
+        total += workingSet;
+        active++;
+        if (status == ProcessStatus::Waiting && workingSet > 0) {
+            candidates.push_back({ process, workingSet });
+        }
+    }
+
+    // Thrashing: suspend the lowest-priority (most recently created) ready processes until the rest fit
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first->getId() > b.first->getId();
+        });
+    for (const auto& [process, workingSet] : candidates) {
+        if (!thrashing || total <= frames || active <= 1) break;
+
+        processManager.updateProcessStatus(process->getName(), ProcessStatus::Suspended);
+        {
+            std::lock_guard<std::mutex> queueLock(queueMutex);
+            dequeueReady(process->getName());
+        }
+        memoryManager.swapOutProcess(process.get());
+        memoryManager.deallocateMemory(process->getName());
+        suspendedProcesses.push_back({ process->getName(), workingSet });
+        suspensionCount++;
+
+        total -= workingSet;
+        active--;
+    }
+
+    // Room again: resume suspended processes in the order they were suspended while they still fit
+    std::lock_guard<std::mutex> queueLock(queueMutex);
+    while (!suspendedProcesses.empty() &&
+        (active == 0 || total + suspendedProcesses.front().second <= frames)) {
+        auto [name, workingSet] = suspendedProcesses.front();
+        suspendedProcesses.pop_front();
+
+        if (auto process = processManager.getProcess(name)) {
+            memoryManager.swapInProcess(process.get());
+        }
+        processManager.updateProcessStatus(name, ProcessStatus::Waiting);
+        enqueueReady(name);
+        resumeCount++;
+
+        total += workingSet;
+        active++;
+    }
+
+    workingSetTotal.store(total);
+}
+
+void CPUScheduler::handleSwapping() {
+    int residency = Config::getSwapResidency();
+    if (residency <= 0) return;
+    long long now = cpuTicks.load();
+
+    // Swap in oldest first, once a process has been out for a residency and its block fits again
+    while (!swappedProcesses.empty()) {
+        auto [name, swappedOutTick] = swappedProcesses.front();
+        auto process = processManager.getProcess(name);
+        if (process && (now - swappedOutTick < residency || !memoryManager.allocateMemory(name))) {
+            break;
+        }
+        swappedProcesses.pop_front();
+        if (!process) continue;
+
+        memoryManager.swapInProcess(process.get());
+        swapInTicks[name] = now;
+        swapInCount++;
+
+        // A process swapped out mid-sleep sleeps out the rest before it is ready again
+        if (process->getSleepCyclesRemaining() > 0) {
+            processManager.updateProcessStatus(name, ProcessStatus::Sleeping);
+            continue;
+        }
+        processManager.updateProcessStatus(name, ProcessStatus::Waiting);
+        std::lock_guard<std::mutex> queueLock(queueMutex);
+        enqueueReady(name);
+    }
+
+    String blocked;
+    blocked.swap(memoryBlockedProcess);
+    if (blocked.empty() || memoryManager.hasMemoryFor(blocked)) return;
+
+    // Victims are idle processes holding a block that were not just swapped in: the longest
+    // remaining sleep goes first, as it will be needed last, then the largest blocks
+    std::vector<std::shared_ptr<Process>> victims;
+    for (const auto& [name, process] : processManager.getAllProcesses()) {
+        ProcessStatus status = process->getStatus();
+        if ((status != ProcessStatus::Sleeping && status != ProcessStatus::Waiting) ||
+            process->getAssignedCore() >= 0 || name == blocked || !memoryManager.holdsMemory(name)) {
+            continue;
+        }
+        auto swappedIn = swapInTicks.find(name);
+        if (swappedIn != swapInTicks.end() && now - swappedIn->second < residency) {
+            continue;
+        }
+        victims.push_back(process);
+    }
+    std::sort(victims.begin(), victims.end(), [](const auto& a, const auto& b) {
+        if (a->getSleepCyclesRemaining() != b->getSleepCyclesRemaining()) {
+            return a->getSleepCyclesRemaining() > b->getSleepCyclesRemaining();
+        }
+        return a->getMemorySize() > b->getMemorySize();
+        });
+
+    for (const auto& victim : victims) {
+        if (memoryManager.hasMemoryFor(blocked)) break;
+
+        processManager.updateProcessStatus(victim->getName(), ProcessStatus::Suspended);
+        {
+            std::lock_guard<std::mutex> queueLock(queueMutex);
+            dequeueReady(victim->getName());
+        }
+        memoryManager.swapOutProcess(victim.get());
+        memoryManager.deallocateMemory(victim->getName());
+        swappedProcesses.push_back({ victim->getName(), now });
+        swapInTicks.erase(victim->getName());
+        swapOutCount++;
+    }
+}
+
 void CPUScheduler::handleProcessCompletion() {
     // Get all finished processes and deallocate their memory
     auto finishedProcesses = processManager.getProcessesByStatus(ProcessStatus::Finished);
@@ -243,6 +422,8 @@ void CPUScheduler::handleProcessCompletion() {
     for (const String& processName : finishedProcesses) {
         // Deallocate memory when process finishes
         memoryManager.deallocateMemory(processName);
+        swapInTicks.erase(processName);
+        localitySkips.erase(processName);
     }
     
     // Note: Keep finished processes in ProcessManager for reporting purposes
@@ -281,7 +462,7 @@ void CPUScheduler::handleQuantumExpiration() {
         for (const String& processName : preemptedProcesses) {
             auto process = processManager.getProcess(processName);
             if (process && process->getStatus() != ProcessStatus::Finished) {
-                roundRobinQueue.push_back(processName);
+                enqueueReady(processName);
             }
         }
     }
@@ -293,16 +474,26 @@ void CPUScheduler::scheduleWaitingProcesses() {
     String algorithm = Config::getScheduler();
     auto availableCores = coreManager.getAvailableCores();
 
-    for (int coreId : availableCores) {
+    // One dispatch attempt per core that was free at the start of the tick. Per-core run queues
+    // feed only their own core; the shared queue feeds whichever free core suits the process.
+    const std::vector<int> freeCores = availableCores;
+    bool perCoreQueues = runQueues.size() > 1;
+    for (size_t slot = 0; slot < freeCores.size(); ++slot) {
         String processName = "";
+        std::deque<String>& runQueue = runQueues[perCoreQueues ? freeCores[slot] : 0];
 
         if (algorithm == "fcfs" && !fcfsQueue.empty()) {
             processName = fcfsQueue.front();
             fcfsQueue.pop();
         }
-        else if (algorithm == "rr" && !roundRobinQueue.empty()) {
-            processName = roundRobinQueue.front();
-            roundRobinQueue.pop_front();
+        else if (algorithm == "rr" && !runQueue.empty()) {
+            if (Config::getLocalityLookahead() > 0) {
+                processName = takeLocalityPick(runQueue);
+            }
+            else {
+                processName = runQueue.front();
+                runQueue.pop_front();
+            }
         }
 
         if (processName.empty() || !processManager.hasProcess(processName)) {
@@ -314,20 +505,40 @@ void CPUScheduler::scheduleWaitingProcesses() {
             continue;
         }
 
+        // Stale queue entry for a process blocked on the pager, suspended by load control or
+        // already on a core; it is requeued when its fault is serviced or it is resumed
+        if (process->getStatus() == ProcessStatus::PageFaultWait || process->getStatus() == ProcessStatus::Suspended ||
+            process->getAssignedCore() >= 0) {
+            continue;
+        }
+
         // TOBEDELETED: CRITICAL FIX - Check if memory is available before assigning to core
         // TOBEDELETED: This enforces the memory bottleneck - if no memory, process waits!
         if (!memoryManager.allocateMemory(processName)) {
             // TOBEDELETED: Not enough memory - put process back in queue and continue to next core
-            if (algorithm == "fcfs") {
-                fcfsQueue.push(processName);
-            }
-            else if (algorithm == "rr") {
-                roundRobinQueue.push_front(processName);
+            // Requeue at the back so processes already holding memory (e.g. back from a page fault) still get dispatched.
+            // The medium-term scheduler swaps someone out for the first such process next tick.
+            if (memoryBlockedProcess.empty()) {
+                memoryBlockedProcess = processName;
             }
+            enqueueReady(processName);
             continue;
         }
 
+        // Affinity: back onto the core the process last ran on if it is free, otherwise the lowest free core
+        int preferredCore = perCoreQueues ? freeCores[slot] : process->getLastCore();
+        auto coreIt = std::find(availableCores.begin(), availableCores.end(), preferredCore);
+        if (coreIt == availableCores.end()) {
+            coreIt = availableCores.begin();
+        }
+        int coreId = *coreIt;
+        availableCores.erase(coreIt);
+
         if (coreManager.tryAssignProcess(coreId, processName)) {
+            if (process->noteDispatch(coreId, Config::getMigrationPenalty())) {
+                migrationCount++;
+            }
+            memoryManager.switchTlbContext(coreId, process->getId());
             processManager.setProcessCore(processName, coreId);
             processManager.updateProcessStatus(processName, ProcessStatus::Running);
 
@@ -339,16 +550,202 @@ void CPUScheduler::scheduleWaitingProcesses() {
             // TOBEDELETED: Core assignment failed - deallocate the reserved memory
             memoryManager.deallocateMemory(processName);
             
-            if (algorithm == "fcfs") {
-                fcfsQueue.push(processName);
-            }
-            else if (algorithm == "rr") {
-                roundRobinQueue.push_front(processName);
+            enqueueReady(processName, true);
+        }
+    }
+}
+
+
+String CPUScheduler::takeLocalityPick(std::deque<String>& runQueue) {
+    size_t window = std::min(runQueue.size(), static_cast<size_t>(Config::getLocalityLookahead()));
+    std::vector<LocalityCandidate> candidates(window);
+    for (size_t i = 0; i < window; ++i) {
+        auto process = processManager.getProcess(runQueue[i]);
+        if (!process || process->getStatus() != ProcessStatus::Waiting || process->getAssignedCore() >= 0) {
+            continue;
+        }
+        auto skips = localitySkips.find(runQueue[i]);
+        candidates[i].ready = true;
+        candidates[i].skips = skips != localitySkips.end() ? skips->second : 0;
+        candidates[i].residentRatio = memoryManager.getResidentRatio(process.get());
+    }
+
+    // Every ready process dispatched over counts toward its skip limit
+    size_t pick = pickByLocality(candidates, MAX_LOCALITY_SKIPS);
+    bool outOfOrder = false;
+    for (size_t i = 0; i < pick; ++i) {
+        if (candidates[i].ready) {
+            localitySkips[runQueue[i]]++;
+            outOfOrder = true;
+        }
+    }
+    if (outOfOrder) {
+        localityPickCount++;
+    }
+
+    String processName = runQueue[pick];
+    runQueue.erase(runQueue.begin() + pick);
+    localitySkips.erase(processName);
+    return processName;
+}
+
+size_t CPUScheduler::pickByLocality(const std::vector<LocalityCandidate>& candidates, int maxSkips) {
+    // Within the lookahead, dispatch the ready process with the largest share of its touched pages
+    // still resident, so it runs instead of faulting. Ties keep queue order, and the first process
+    // already passed over maxSkips times goes ahead of everyone, which bounds the unfairness.
+    size_t pick = 0;
+    double bestRatio = -1.0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (!candidates[i].ready) {
+            continue;
+        }
+        if (candidates[i].skips >= maxSkips) {
+            return i;
+        }
+        if (candidates[i].residentRatio > bestRatio) {
+            pick = i;
+            bestRatio = candidates[i].residentRatio;
+        }
+    }
+    return pick;
+}
+
+std::deque<String>& CPUScheduler::runQueueFor(const String& processName) {
+    if (runQueues.size() == 1) {
+        return runQueues[0];
+    }
+
+    // Back to the queue of the core it last ran on; a process that has not run yet joins the shortest
+    auto process = processManager.getProcess(processName);
+    int lastCore = process ? process->getLastCore() : -1;
+    if (lastCore >= 0 && lastCore < static_cast<int>(runQueues.size())) {
+        return runQueues[lastCore];
+    }
+    return *std::min_element(runQueues.begin(), runQueues.end(), [](const auto& a, const auto& b) {
+        return a.size() < b.size();
+        });
+}
+
+void CPUScheduler::enqueueReady(const String& processName, bool front) {
+    String algorithm = Config::getScheduler();
+    if (algorithm == "fcfs") {
+        fcfsQueue.push(processName);
+    }
+    else if (algorithm == "rr") {
+        std::deque<String>& runQueue = runQueueFor(processName);
+        if (front) {
+            runQueue.push_front(processName);
+        }
+        else {
+            runQueue.push_back(processName);
+        }
+    }
+}
+
+void CPUScheduler::dequeueReady(const String& processName) {
+    // std::queue has no erase, so FCFS rebuilds its queue without the process
+    std::queue<String> kept;
+    while (!fcfsQueue.empty()) {
+        if (fcfsQueue.front() != processName) {
+            kept.push(fcfsQueue.front());
+        }
+        fcfsQueue.pop();
+    }
+    fcfsQueue.swap(kept);
+
+    for (std::deque<String>& runQueue : runQueues) {
+        runQueue.erase(std::remove(runQueue.begin(), runQueue.end(), processName), runQueue.end());
+    }
+}
+
+void CPUScheduler::handleLoadBalancing() {
+    int period = Config::getBalancePeriod();
+    if (runQueues.size() <= 1 || period <= 0 || cpuTicks.load() % period != 0) return;
+
+    std::lock_guard<std::mutex> queueLock(queueMutex);
+
+    // Load per core: its running process plus the ready processes in its queue, counted both as
+    // processes and as instructions left. Stale entries are left alone; they are skipped at dispatch.
+    std::vector<RunQueueLoad> loads(runQueues.size());
+    for (size_t core = 0; core < runQueues.size(); ++core) {
+        if (auto running = processManager.getProcess(coreManager.getAssignment(static_cast<int>(core)))) {
+            loads[core].length++;
+            loads[core].work += running->getRemainingInstructions();
+        }
+        for (const String& name : runQueues[core]) {
+            auto process = processManager.getProcess(name);
+            if (process && process->getStatus() == ProcessStatus::Waiting && process->getAssignedCore() < 0) {
+                loads[core].length++;
+                loads[core].work += process->getRemainingInstructions();
+                loads[core].movable.emplace_back(name, process->getRemainingInstructions());
             }
         }
     }
+
+    balanceMigrationCount += applyLoadBalance(runQueues, planLoadBalance(std::move(loads), Config::getBalanceQueueThreshold(),
+        Config::getBalanceWorkThreshold()));
 }
 
+int CPUScheduler::applyLoadBalance(std::vector<std::deque<String>>& queues, const std::vector<BalanceMove>& moves) {
+    int applied = 0;
+    for (const BalanceMove& move : moves) {
+        std::deque<String>& from = queues[move.fromCore];
+        auto it = std::find(from.begin(), from.end(), move.processName);
+        if (it == from.end()) continue;
+        from.erase(it);
+        queues[move.toCore].push_back(move.processName);
+        applied++;
+    }
+    return applied;
+}
+
+std::vector<CPUScheduler::BalanceMove> CPUScheduler::planLoadBalance(std::vector<RunQueueLoad> loads, int queueThreshold,
+    long long workThreshold) {
+    std::vector<BalanceMove> moves;
+    size_t cores = loads.size();
+    if (cores <= 1) return moves;
+
+    // A gap of one process can't be closed, only flipped, so queue balancing needs at least two
+    queueThreshold = std::max(2, queueThreshold);
+    auto byLoad = [&](size_t a, size_t b) {
+        return loads[a].length != loads[b].length ? loads[a].length < loads[b].length : loads[a].work < loads[b].work;
+    };
+
+    // Every move shrinks the gap it was made for, so this settles; the cap is only a backstop
+    for (size_t step = 0; step < cores * 8; ++step) {
+        std::vector<size_t> order(cores);
+        for (size_t core = 0; core < cores; ++core) {
+            order[core] = core;
+        }
+        size_t busiest = *std::max_element(order.begin(), order.end(), byLoad);
+        size_t idlest = *std::min_element(order.begin(), order.end(), byLoad);
+        long long workGap = loads[busiest].work - loads[idlest].work;
+        bool queueImbalance = loads[busiest].length - loads[idlest].length >= queueThreshold;
+        bool workImbalance = workThreshold > 0 && loads[busiest].length > 1 && workGap >= workThreshold;
+        if (busiest == idlest || (!queueImbalance && !workImbalance)) break;
+
+        // Move the queued process whose remaining work comes closest to evening out the two cores
+        auto& from = loads[busiest].movable;
+        auto best = from.end();
+        for (auto it = from.begin(); it != from.end(); ++it) {
+            if (best == from.end() || std::llabs(workGap - 2 * it->second) < std::llabs(workGap - 2 * best->second)) {
+                best = it;
+            }
+        }
+        // A work-only imbalance is worth a move only if it leaves the cores closer than before
+        if (best == from.end() || (!queueImbalance && best->second >= workGap)) break;
+
+        long long bestWork = best->second;
+        moves.push_back({ best->first, static_cast<int>(busiest), static_cast<int>(idlest) });
+        loads[idlest].movable.push_back(*best);
+        from.erase(best);
+        loads[busiest].length--;
+        loads[idlest].length++;
+        loads[busiest].work -= bestWork;
+        loads[idlest].work += bestWork;
+    }
+    return moves;
+}
 
 void CPUScheduler::startProcessGeneration() {
     if (generatorRunning.load()) return;
@@ -388,8 +785,10 @@ std::shared_ptr<Process> CPUScheduler::createRandomProcess(const String& name) {
     int minIns = Config::getMinIns();
     int maxIns = Config::getMaxIns();
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // The program seed also rolls the length and memory size, so processes drawing the same
+    // program variant get the same shape and share one image
+    int programSeed = ProgramCache::pickSeed();
+    std::mt19937 gen(static_cast<uint32_t>(programSeed));
     std::uniform_int_distribution<> insDis(minIns, maxIns);
 
     int numInstructions = insDis(gen);
@@ -421,7 +820,7 @@ std::shared_ptr<Process> CPUScheduler::createRandomProcess(const String& name) {
     if (memorySize > 65536) memorySize = 65536;
     if (memorySize < 64) memorySize = 64;
 
-    return std::make_shared<Process>(name, nextProcessId - 1, numInstructions, memorySize);
+    return std::make_shared<Process>(name, nextProcessId - 1, numInstructions, memorySize, "", programSeed);
 }
 
 
@@ -452,6 +851,18 @@ void CPUScheduler::removeProcess(const String& processName) {
     processManager.removeProcess(processName);
 }
 
+std::shared_ptr<Process> CPUScheduler::forkProcess(const String& sourceName, const String& childName) {
+    if (processManager.hasProcess(childName)) {
+        return nullptr;
+    }
+
+    auto child = processManager.forkProcess(sourceName, childName, getNextProcessId(), memoryManager);
+    if (child) {
+        addProcess(child);
+    }
+    return child;
+}
+
 // Process information delegation methods
 std::shared_ptr<Process> CPUScheduler::getProcess(const String& processName) const {
     return processManager.getProcess(processName);
@@ -504,11 +915,11 @@ void CPUScheduler::executeProcessDirectly(const String& processName) {
     }
 
     // Make sure memory changes persist by marking pages as accessed
-    for (const auto& [pageNum, entry] : process->getPageTable()) {
+    process->getPageTable().forEachMapped([&](int pageNumber, const PageTableEntry& entry) {
         if (entry.valid) {
-            memoryManager.markPageAccessed(entry.frameNumber);
+            memoryManager.markPageAccessed(entry.frameNumber, process.get(), pageNumber);
         }
-    }
+    });
 
     std::cout << "Executed " << executedCount << " total instructions." << std::endl;
 
@@ -6,6 +6,7 @@
 #include "MemoryManager.h"
 #include <queue>
 #include <deque>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <thread>
@@ -29,6 +30,7 @@ public:
     // Process management
     void addProcess(std::shared_ptr<Process> process);
     void removeProcess(const String& processName);
+    std::shared_ptr<Process> forkProcess(const String& sourceName, const String& childName); // nullptr if it can't be forked
     
     // Auto process generation (scheduler-start functionality)
     void startProcessGeneration();
@@ -64,6 +66,48 @@ public:
     void dumpBackingStoreToFile(const std::string& filename = "csopesy-backing-store.txt") const;
 
     int getNextProcessId();
+
+    // Load control (working-set driven suspension)
+    int getWorkingSetTotal() const { return workingSetTotal.load(); }
+    int getSuspensionCount() const { return suspensionCount.load(); }
+    int getResumeCount() const { return resumeCount.load(); }
+
+    // Medium-term scheduling (whole-process swapping for processes blocked on memory)
+    int getSwapOutCount() const { return swapOutCount.load(); }
+    int getSwapInCount() const { return swapInCount.load(); }
+
+    // Locality-aware dispatch
+    int getLocalityPickCount() const { return localityPickCount.load(); }
+    struct LocalityCandidate {
+        bool ready = false;         // Waiting and off every core; other queue entries are stale
+        double residentRatio = 0.0; // Share of its touched pages still resident
+        int skips = 0;              // Times it was passed over for a process with more pages resident
+    };
+    // Index of the queue entry to dispatch next (0 if none is ready); no scheduler state is touched
+    static size_t pickByLocality(const std::vector<LocalityCandidate>& candidates, int maxSkips);
+
+    // Core affinity
+    int getMigrationCount() const { return migrationCount.load(); }
+    int getWarmupStallTicks() const { return warmupStallTicks.load(); }
+
+    // Load balancing between per-core run queues
+    int getBalanceMigrationCount() const { return balanceMigrationCount.load(); }
+
+    struct RunQueueLoad {
+        int length = 0;         // Running process plus the ready processes queued on the core
+        long long work = 0;     // Instructions left across them
+        std::vector<std::pair<String, long long>> movable;  // Queued processes that may move, with their work left
+    };
+    struct BalanceMove {
+        String processName;
+        int fromCore;
+        int toCore;
+    };
+    // The moves that even out the cores, in the order to apply them; no scheduler state is touched
+    static std::vector<BalanceMove> planLoadBalance(std::vector<RunQueueLoad> loads, int queueThreshold, long long workThreshold);
+    // Moves each planned process to the back of its new core's queue, skipping any no longer queued
+    // where the plan found it; returns the moves made
+    static int applyLoadBalance(std::vector<std::deque<String>>& queues, const std::vector<BalanceMove>& moves);
     
     void executeProcessDirectly(const String& processName);
     
@@ -86,7 +130,7 @@ private:
     
     // Process queues (depending on algorithm)
     std::queue<String> fcfsQueue;           // FCFS ready queue
-    std::deque<String> roundRobinQueue;     // RR ready queue (circular)
+    std::vector<std::deque<String>> runQueues; // RR ready queues (circular): one per core with per-core run queues, else one shared
     
     // Thread synchronization (only for queues now!)
     std::mutex queueMutex;
@@ -97,6 +141,32 @@ private:
     std::atomic<long long> cpuTicks;
     std::atomic<int> nextProcessId;
     
+    // Load control: processes swapped out to stop thrashing, in suspension order,
+    // with the working set each had when it was suspended
+    std::deque<std::pair<String, int>> suspendedProcesses;
+    int loadControlFaults = 0;              // Fault count at the last load-control pass
+    std::atomic<int> workingSetTotal{ 0 };
+    std::atomic<int> suspensionCount{ 0 };
+    std::atomic<int> resumeCount{ 0 };
+
+    // Medium-term scheduling: idle processes swapped out whole so a ready process could get its
+    // memory block, in swap-out order with the tick each left, and the tick each came back in
+    std::deque<std::pair<String, long long>> swappedProcesses;
+    std::unordered_map<String, long long> swapInTicks;
+    String memoryBlockedProcess;            // First process the last dispatch found no block for ("" if none)
+    std::atomic<int> swapOutCount{ 0 };
+    std::atomic<int> swapInCount{ 0 };
+
+    // Locality-aware dispatch: times each ready process was passed over for one with more pages resident
+    std::unordered_map<String, int> localitySkips;
+    std::atomic<int> localityPickCount{ 0 };    // Dispatches taken out of queue order
+    static const int MAX_LOCALITY_SKIPS = 3;    // After this many, a process is dispatched in queue order
+
+    // Core affinity: dispatches that moved a process off its last core, and core ticks lost to the cold caches
+    std::atomic<int> migrationCount{ 0 };
+    std::atomic<int> warmupStallTicks{ 0 };
+    std::atomic<int> balanceMigrationCount{ 0 };   // Queued processes the balancer moved to another core's queue
+    
     // Timing
     std::chrono::steady_clock::time_point startTime;
     
@@ -107,7 +177,17 @@ private:
     // Scheduling operations (clean, no deadlocks!)
     void handleProcessExecution();    // Execute instructions for running processes
     void handleSleepingProcesses();   // Handle sleeping processes and wake them up
+    void handlePageFaults();          // Requeue processes whose blocked page faults were serviced
+    void handleLoadControl();         // Suspend processes while memory thrashes, resume them once working sets fit
+    void handleSwapping();            // Medium-term scheduler: swap idle processes out for blocked ones, and back in
     void handleProcessCompletion();   // Remove finished processes
     void handleQuantumExpiration();   // Preempt processes whose quantum expired
     void scheduleWaitingProcesses();  // Assign waiting processes to available cores
+    String takeLocalityPick(std::deque<String>& runQueue); // Removes and returns the entry to dispatch next; assumes queueMutex held
+    void handleLoadBalancing();       // Move queued work from the busiest core's run queue to the idlest
+
+    // Ready-queue placement; both assume queueMutex held
+    std::deque<String>& runQueueFor(const String& processName);  // Last core's queue, else the shortest
+    void enqueueReady(const String& processName, bool front = false);
+    void dequeueReady(const String& processName);   // Drops every queued entry for the process
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "SelfCheck.h"
+#include <iostream>
+
+namespace SelfCheck {
+    bool runAll() {
+        std::cout << "Memory and scheduler self-check" << std::endl;
+        int failedChecks = 0;
+        // In the order the features were added, so the first failure points at the earliest broken one
+        bool (*const checks[])() = {
+            checkPhysicalMemory,
+            checkFrameBitmap,
+            checkBackingStore,
+            checkEvictReload,
+            checkWriteBehind,
+            checkBlockingFaults,
+            checkReplacementPolicies,
+            checkReadahead,
+            checkWorkingSet,
+            checkCompressedPool,
+            checkBuddyAllocator,
+            checkConcurrentFaults,
+            checkPageTable,
+            checkTlb,
+            checkHugePages,
+            checkFork,
+            checkProgramImages,
+            checkSharedCode,
+            checkMerge,
+            checkSwapping,
+            checkLocalityPick,
+            checkCoreAffinity,
+            checkLoadBalancing,
+        };
+        for (auto check : checks) {
+            failedChecks += check() ? 0 : 1;
+        }
+
+        if (failedChecks > 0) {
+            std::cout << "\033[31m" << failedChecks << " check(s) FAILED\033[0m" << std::endl;
+            return false;
+        }
+        std::cout << "\033[32mAll checks passed\033[0m" << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "TypedefRepo.h"
+
+// Behavior checks for the memory subsystem, program cache and scheduler, run by the self-check console
+// command in Debug builds (the SelfCheck*.cpp files are left out of Release). Each check builds its
+// own stores and managers, so the live emulator state is never touched; every mismatch is printed
+// as it is found, and a check returns false if any failed. Shared scaffolding is in SelfCheckFixture.h.
+namespace SelfCheck {
+    // Runs every check below; prints a summary and returns false if any check failed
+    bool runAll();
+
+    // Each process's cells live in its own frames at their offsets; processes never alias one another
+    bool checkPhysicalMemory();
+
+    // Lowest-first allocation, aligned runs inside a word and across whole words, and no frame handed out twice under contention
+    bool checkFrameBitmap();
+
+    // Slot reuse after a discard, batched writes landing on one run, and merged batched reads
+    bool checkBackingStore();
+
+    // Page contents survive eviction and reload under every replacement policy, and clean pages are not written back
+    bool checkEvictReload();
+
+    // Threads racing writes, discards and slot reuse on shared pages never read another page's image, queued or not
+    bool checkWriteBehind();
+
+    // A scheduled fault parks the process until the pager has spent its latency, one fault at a time, then the instruction runs
+    bool checkBlockingFaults();
+
+    // Each policy picks the victim its algorithm names: second chance, least recent, idle past the window, and scan resistance
+    bool checkReplacementPolicies();
+
+    // Code readahead grows on sequential faults, shrinks on jumps, and only ever takes free frames
+    bool checkReadahead();
+
+    // A working set counts the pages referenced within the window, and the resident ratio drops as pages are evicted
+    bool checkWorkingSet();
+
+    // Every codec round-trips its page, noise is rejected, and a full pool spills to the file intact
+    bool checkCompressedPool();
+
+    // Requests round up to a power-of-two block, splits take the lowest fitting block, and releases coalesce buddies back up
+    bool checkBuddyAllocator();
+
+    // Threads faulting and evicting each other's pages concurrently, with a console reader alongside, never lose or cross-wire a cell
+    bool checkConcurrentFaults();
+
+    // Leaves are allocated only for touched ranges, lookups find what was mapped, and copies are deep
+    bool checkPageTable();
+
+    // Huge entries cover their whole run, shootdowns drop the covering entry, and switches flush
+    bool checkTlb();
+
+    // A large process faults in whole aligned runs, falls back to base pages without one, and a split run keeps its contents
+    bool checkHugePages();
+
+    // Parent and child writes stay private after a fork, through eviction too, and a sleeping parent's child sleeps
+    bool checkFork();
+
+    // Identical programs decode once and are shared by every process running them, until the last one exits
+    bool checkProgramImages();
+
+    // A code page one process loaded is mapped, not reread, by others running the same program, until it is evicted
+    bool checkSharedCode();
+
+    // Identical stable pages merge into one frame, and a write unmerges only the writer's copy
+    bool checkMerge();
+
+    // Swapping a process out frees its frames in one batch, and swapping it in maps the same pages back with their contents
+    bool checkSwapping();
+
+    // Dispatch prefers the ready process with the most pages resident, in queue order on ties, until one hits its skip limit
+    bool checkLocalityPick();
+
+    // Only a dispatch to a different core is a migration, and it stalls the process for exactly the warm-up penalty
+    bool checkCoreAffinity();
+
+    // The balancer's plan evens out queue lengths and work without flipping the gap, and applying it skips stale moves
+    bool checkLoadBalancing();
+}
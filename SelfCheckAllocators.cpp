@@ -0,0 +1,128 @@
+#include "SelfCheck.h"
+#include "SelfCheckFixture.h"
+#include "BuddyAllocator.h"
+#include "FrameBitmap.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace SelfCheck {
+
+    bool checkFrameBitmap() {
+        Results results("frame bitmap");
+        const int numFrames = 5 * 64;
+        FrameBitmap bitmap(numFrames);
+
+        results.expect(bitmap.allocate() == 0 && bitmap.allocate() == 1 && bitmap.allocate() == 2,
+            "frames are handed out lowest first");
+        bitmap.release(1);
+        results.expect(bitmap.isFree(1) && bitmap.allocate() == 1, "a released frame is the next one handed out");
+
+        // A run is aligned to its length, so frames 0-2 being taken pushes a run of four to frame 4
+        int run = bitmap.allocateRun(4);
+        bool runTaken = run == 4;
+        for (int frame = 4; frame < 8; ++frame) {
+            runTaken = runTaken && !bitmap.isFree(frame);
+        }
+        results.expect(runTaken && bitmap.isFree(3) && bitmap.getUsedCount() == 7, "a short run takes the first aligned free block");
+
+        // Runs of a word or more take whole free words; word 0 is partly used
+        int wordRun = bitmap.allocateRun(64);
+        int doubleRun = bitmap.allocateRun(128);
+        results.expect(wordRun == 64 && doubleRun == 128, "word-sized runs skip a partly used word");
+        results.expect(bitmap.allocateRun(128) == -1 && bitmap.getUsedCount() == 7 + 64 + 128,
+            "a run that does not fit fails and claims nothing");
+        bitmap.release(64 + 10);
+        results.expect(bitmap.allocateRun(64) == 256 && bitmap.allocate() == 3 && bitmap.allocate() == 8,
+            "a word with one frame free is not a whole free word");
+        results.expect(bitmap.allocateRun(2) == 10, "a two-frame run starts on an even frame");
+        results.expect(bitmap.getFreeCount() + bitmap.getUsedCount() == numFrames, "free and used counts add up");
+
+        // Threads racing for every frame each get distinct frames, and together get all of them
+        FrameBitmap contended(numFrames);
+        const int threadCount = 4;
+        std::vector<std::vector<int>> taken(threadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int frame = contended.allocate(); frame >= 0; frame = contended.allocate()) {
+                    taken[t].push_back(frame);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::vector<int> all;
+        for (const auto& frames : taken) {
+            all.insert(all.end(), frames.begin(), frames.end());
+        }
+        std::sort(all.begin(), all.end());
+        results.expect(static_cast<int>(all.size()) == numFrames && std::adjacent_find(all.begin(), all.end()) == all.end(),
+            "concurrent allocation hands out every frame exactly once");
+        results.expect(contended.getFreeCount() == 0 && contended.allocate() == -1, "a full bitmap has nothing left");
+
+        threads.clear();
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int frame : taken[t]) {
+                    contended.release(frame);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        results.expect(contended.getFreeCount() == numFrames && contended.allocateRun(128) == 0,
+            "concurrent releases leave every frame free again");
+
+        return results.finish();
+    }
+
+    bool checkBuddyAllocator() {
+        Results results("buddy allocator");
+        using Blocks = std::vector<std::pair<int, int>>;
+        BuddyAllocator buddy(1024);
+
+        // 100 bytes rounds up to 128: the 1024 block splits down, leaving one free buddy per order
+        int a = buddy.allocate(100);
+        results.expect(a == 0 && buddy.getFreeBlocks() == Blocks({ { 128, 128 }, { 256, 256 }, { 512, 512 } }),
+            "a request splits the smallest block that fits and keeps each buddy free");
+        results.expect(buddy.getInternalFragmentation() == 28 && buddy.getFreeBytes() == 1024 - 128,
+            "rounding waste is counted as internal fragmentation");
+
+        // Small requests fill the lowest free blocks first
+        int b = buddy.allocate(64);
+        int c = buddy.allocate(64);
+        int d = buddy.allocate(256);
+        results.expect(b == 128 && c == 192 && d == 256, "allocations take the lowest free block of their order");
+        results.expect(buddy.allocate(1024) == -1 && !buddy.canAllocate(1024) && buddy.canAllocate(512),
+            "a request larger than any free block fails");
+
+        // A block only merges with its own buddy: freeing 0 and 192 leaves two separate holes
+        buddy.release(a);
+        buddy.release(c);
+        results.expect(buddy.getFreeBlocks() == Blocks({ { 0, 128 }, { 192, 64 }, { 512, 512 } }),
+            "blocks whose buddies are in use stay apart");
+        buddy.release(b);
+        results.expect(buddy.getFreeBlocks() == Blocks({ { 0, 256 }, { 512, 512 } }),
+            "freeing the last buddy coalesces every level it completes");
+        results.expect(!buddy.release(b) && !buddy.release(100), "releasing an address that is not a block fails");
+        buddy.release(d);
+        results.expect(buddy.getFreeBlocks() == Blocks({ { 0, 1024 } }) && buddy.getLargestFreeBlock() == 1024 &&
+            buddy.getInternalFragmentation() == 0, "an empty allocator is one block again");
+
+        // A total that is not a power of two is carved into several top-level blocks that never merge
+        BuddyAllocator uneven(1024 + 256);
+        results.expect(uneven.getFreeBlocks() == Blocks({ { 0, 1024 }, { 1024, 256 } }),
+            "an uneven total splits into power-of-two blocks");
+        int big = uneven.allocate(1024);
+        int small = uneven.allocate(256);
+        uneven.release(big);
+        uneven.release(small);
+        results.expect(big == 0 && small == 1024 && uneven.getFreeBlocks() == Blocks({ { 0, 1024 }, { 1024, 256 } }),
+            "top-level blocks come back without merging past the end");
+
+        return results.finish();
+    }
+}
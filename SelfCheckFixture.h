@@ -0,0 +1,57 @@
+#pragma once
+#include "TypedefRepo.h"
+#include "MemoryManager.h"
+#include "process.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Shared scaffolding for the SelfCheck*.cpp checks; not used by the emulator itself
+namespace SelfCheck {
+    // Scratch backing store so checks never clobber csopesy-backing-store-data.bin
+    inline const String SCRATCH_STORE = "csopesy-selfcheck-store.bin";
+    // Memory checks build their managers from fixed settings, so the configured frame size,
+    // huge pages, pool or pager latency never change what they test
+    inline constexpr int FRAME_SIZE = 64;
+
+    // Pass/fail tally for one check; failures are reported the moment they happen
+    struct Results {
+        const char* name;
+        int passed = 0;
+        int failed = 0;
+
+        explicit Results(const char* name) : name(name) {}
+
+        void expect(bool ok, const String& what) {
+            if (ok) {
+                passed++;
+                return;
+            }
+            failed++;
+            std::cout << "\033[31mFAIL " << name << ": " << what << "\033[0m" << std::endl;
+        }
+
+        bool finish() const {
+            std::cout << (failed == 0 ? "\033[32mok  \033[0m " : "\033[31mFAIL\033[0m ") << name << " ("
+                      << passed << " passed, " << failed << " failed)" << std::endl;
+            return failed == 0;
+        }
+    };
+
+    // A page image that differs for every (seed, page) pair, so a page read from the wrong slot shows up
+    inline std::vector<uint8_t> makePage(int pageSize, int seed) {
+        std::vector<uint8_t> page(pageSize);
+        for (int i = 0; i < pageSize; ++i) {
+            page[i] = static_cast<uint8_t>(seed * 31 + i * 7 + 1);
+        }
+        return page;
+    }
+
+    // A one-instruction process of the given size, registered with mm; checks drive its memory directly
+    inline std::shared_ptr<Process> attachProcess(MemoryManager& mm, const String& name, int id, int bytes) {
+        auto proc = std::make_shared<Process>(name, id, 1, bytes);
+        proc->setMemoryManager(&mm);
+        mm.registerProcess(proc);
+        return proc;
+    }
+}
@@ -0,0 +1,857 @@
+#include "SelfCheck.h"
+#include "SelfCheckFixture.h"
+#include "PageTable.h"
+#include "ReplacementPolicy.h"
+#include "TLB.h"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace SelfCheck {
+    bool checkPhysicalMemory() {
+        Results results("physical memory");
+        const int frameSize = FRAME_SIZE;
+        const int pages = 4;
+        MemoryManager mm(2 * pages * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+        auto first = attachProcess(mm, "check-first", 1, pages * frameSize);
+        auto second = attachProcess(mm, "check-second", 2, pages * frameSize);
+
+        // Both processes fill the same virtual addresses, each with its own values
+        auto valueAt = [](int id, uint32_t address) { return static_cast<uint16_t>(id * 10000 + address); };
+        const uint32_t bytes = static_cast<uint32_t>(pages * frameSize);
+        for (uint32_t address = 0; address < bytes; address += 2) {
+            first->setMemoryValueAt(address, valueAt(1, address));
+            second->setMemoryValueAt(address, valueAt(2, address));
+        }
+        results.expect(mm.getUsedFrameCount() == 2 * pages && mm.getPagedOutCount() == 0, "each page holds one frame");
+
+        int mismatches = 0;
+        for (uint32_t address = 0; address < bytes; address += 2) {
+            mismatches += first->readMemoryValueAt(address) != valueAt(1, address) ? 1 : 0;
+            mismatches += second->readMemoryValueAt(address) != valueAt(2, address) ? 1 : 0;
+        }
+        results.expect(mismatches == 0, std::to_string(mismatches) + " cell(s) read another process's value");
+
+        // The frame a page table entry names holds that page's words at their byte offsets
+        bool framesMatch = true;
+        for (int page = 0; page < pages; ++page) {
+            const PageTableEntry* entry = first->getPageTable().find(page);
+            for (int offset = 0; entry && offset < frameSize; offset += 2) {
+                uint32_t address = static_cast<uint32_t>(page * frameSize + offset);
+                framesMatch = framesMatch && mm.readPhysicalWord(entry->frameNumber, offset) == valueAt(1, address);
+            }
+            framesMatch = framesMatch && entry && entry->valid;
+        }
+        results.expect(framesMatch, "a frame holds its page's words at their offsets");
+
+        // Cells are two bytes wide: an odd address names the cell it falls in
+        results.expect(first->readMemoryValueAt(3) == valueAt(1, 2) && first->getMemoryValueAt(3) == valueAt(1, 2),
+            "an odd address reads its aligned cell");
+        results.expect(first->getMemoryDump().size() == bytes / 2, "the dump lists every written cell once");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkEvictReload() {
+        Results results("evict/reload");
+        const int frameSize = FRAME_SIZE;
+        const int cellsPerPage = frameSize / 2;
+        const int numFrames = 8;
+        const int processCount = 4;
+        const int pagesPerProcess = 8;
+        const int writes = 2000;
+
+        for (const char* policy : { "clock", "lru", "wsclock", "2q", "arc" }) {
+            String mode = String(" (") + policy + ")";
+            MemorySettings settings;
+            settings.policyName = policy;
+            MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, settings);
+
+            std::vector<std::shared_ptr<Process>> processes;
+            for (int i = 0; i < processCount; ++i) {
+                processes.push_back(attachProcess(mm, "check" + std::to_string(i), i, pagesPerProcess * frameSize));
+            }
+
+            // Four times as many pages as frames, so nearly every write evicts someone; about
+            // one write in eight stores zero, which lets all-zero pages be dropped instead of written
+            std::vector<std::vector<uint16_t>> expected(processCount, std::vector<uint16_t>(pagesPerProcess * cellsPerPage, 0));
+            std::mt19937 rng(30);
+            for (int n = 0; n < writes; ++n) {
+                int process = static_cast<int>(rng() % processCount);
+                int cell = static_cast<int>(rng() % expected[process].size());
+                uint16_t value = rng() % 8 == 0 ? 0 : static_cast<uint16_t>(rng() | 1);
+                processes[process]->setMemoryValueAt(static_cast<uint32_t>(cell * 2), value);
+                expected[process][cell] = value;
+            }
+            results.expect(mm.getPagedOutCount() > 0, "the workload forced evictions" + mode);
+
+            // Every cell reads back what was last written to it, faulting its page in if needed
+            int mismatches = 0;
+            for (int process = 0; process < processCount; ++process) {
+                for (size_t cell = 0; cell < expected[process].size(); ++cell) {
+                    if (processes[process]->readMemoryValueAt(static_cast<uint32_t>(cell * 2)) != expected[process][cell]) {
+                        mismatches++;
+                    }
+                }
+            }
+            results.expect(mismatches == 0, std::to_string(mismatches) + " cell(s) changed across eviction and reload" + mode);
+
+            // Clean pages are dropped, not written: a read-only sweep can only write back what was
+            // already dirty when it started, so at most one writeback per frame
+            int writebacksBefore = mm.getWritebackCount();
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int process = 0; process < processCount; ++process) {
+                    for (int page = 0; page < pagesPerProcess; ++page) {
+                        processes[process]->readMemoryValueAt(static_cast<uint32_t>(page * frameSize));
+                    }
+                }
+            }
+            results.expect(mm.getWritebackCount() - writebacksBefore <= numFrames,
+                "a read-only sweep writes back no clean pages" + mode);
+        }
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkReplacementPolicies() {
+        Results results("replacement policies");
+        const int numFrames = 4;
+
+        // Drives a policy the way MemoryManager does: the fault is reported first, with every frame
+        // full the victim is unmapped before the new page is mapped, and the faulting reference follows
+        struct Driver {
+            std::unique_ptr<ReplacementPolicy> policy;
+            std::vector<FrameInfo> frames;
+            int nextFree = 0;
+
+            Driver(const char* name, int numFrames) : policy(ReplacementPolicy::create(name, numFrames)), frames(numFrames) {}
+
+            int fault(int page) {
+                uint64_t key = ReplacementPolicy::makePageKey(1, page);
+                policy->onFault(key);
+                int frame = nextFree < static_cast<int>(frames.size()) ? nextFree++ : policy->selectVictim(frames);
+                if (frames[frame].isOccupied) {
+                    policy->onUnmap(frame);
+                }
+                frames[frame].isOccupied = true;
+                frames[frame].pageNumber = page;
+                frames[frame].referenced = true;
+                policy->onMap(frame, key);
+                access(frame);
+                return frame;
+            }
+            void access(int frame) {
+                frames[frame].referenced = true;
+                policy->onAccess(frame);
+            }
+            void fill() {
+                for (int page = 0; page < static_cast<int>(frames.size()); ++page) {
+                    fault(page);
+                }
+            }
+        };
+
+        // Clock: the first sweep clears every bit; after that a touched frame is passed over once
+        Driver clock("clock", numFrames);
+        clock.fill();
+        int first = clock.fault(10);
+        clock.access(2);
+        int second = clock.fault(11);
+        int third = clock.fault(12);
+        results.expect(first == 0 && second == 1 && third == 3, "clock gives a referenced frame a second chance");
+
+        Driver lru("lru", numFrames);
+        lru.fill();
+        lru.access(0);
+        lru.access(1);
+        results.expect(lru.fault(10) == 2 && lru.fault(11) == 3, "lru evicts the least recently used frame");
+
+        // WSClock: frame 0 has its bit cleared and sits idle past the window while the rest are in use
+        Driver wsclock("wsclock", numFrames);
+        wsclock.fill();
+        wsclock.frames[0].referenced = false;
+        for (int round = 0; round < 8; ++round) {
+            for (int frame = 1; frame < numFrames; ++frame) {
+                wsclock.access(frame);
+            }
+        }
+        results.expect(wsclock.fault(10) == 0, "wsclock evicts a page idle past the working-set window");
+
+        // 2Q and ARC: a page touched twice outlives a scan of pages touched once
+        Driver twoQueue("2q", numFrames);
+        twoQueue.fill();
+        int ghosted = twoQueue.fault(10);           // Page 0 leaves first and is remembered as a ghost
+        int hotFrame = twoQueue.fault(0);           // Re-faulted while remembered, so it is promoted
+        bool hotKept = ghosted == 0;
+        for (int page = 20; page < 40; ++page) {
+            hotKept = twoQueue.fault(page) != hotFrame && hotKept;
+        }
+        results.expect(hotKept, "2q keeps a re-referenced page through a scan");
+
+        Driver arc("arc", numFrames);
+        arc.fill();
+        arc.access(0);
+        bool frequentKept = true;
+        for (int page = 20; page < 40; ++page) {
+            frequentKept = arc.fault(page) != 0 && frequentKept;
+        }
+        results.expect(frequentKept, "arc keeps a frequently used page through a scan");
+
+        return results.finish();
+    }
+
+    bool checkBlockingFaults() {
+        Results results("blocking faults");
+        const int frameSize = FRAME_SIZE;
+        const int pages = 4;
+        const int latency = 3;
+        MemorySettings settings;
+        settings.pageFaultLatency = latency;
+        MemoryManager mm(16 * frameSize, frameSize, SCRATCH_STORE, settings);
+
+        // Only a process on a core blocks; direct execution resolves its faults inline
+        auto makeScheduled = [&](const String& name, int id) {
+            auto proc = std::make_shared<Process>(name, id, 2, pages * frameSize, "WRITE 0x80 7; READ x 0x80");
+            proc->setMemoryManager(&mm);
+            mm.registerProcess(proc);
+            proc->setAssignedCore(0);
+            return proc;
+        };
+        auto first = makeScheduled("check-first", 1);
+        first->executeInstruction();
+        results.expect(first->getStatus() == ProcessStatus::PageFaultWait && first->getRemainingInstructions() == 2,
+            "a fault parks the process without running the instruction");
+        results.expect(mm.getPendingFaultCount() == 1 && mm.getBlockedFaultCount() == 1 && !first->getPageTable().isResident(2),
+            "the fault is queued for the pager, not serviced inline");
+
+        // The pager starts on the next tick, so the first fault is ready at 1 + latency; the second queues behind it
+        auto second = makeScheduled("check-second", 2);
+        second->executeInstruction();
+        results.expect(mm.servicePageFaults(latency).empty() && mm.getPendingFaultCount() == 2,
+            "nothing completes before the latency has passed");
+        std::vector<Process*> resumed = mm.servicePageFaults(1 + latency);
+        results.expect(resumed.size() == 1 && resumed[0] == first.get() && mm.getPendingFaultCount() == 1,
+            "the first fault completes after its latency");
+        results.expect(first->getPageTable().isResident(2) && first->getPageTable().isResident(first->getCodePage(0)),
+            "the data page and the code page are both mapped");
+        results.expect(mm.servicePageFaults(2 * latency).empty(), "the pager serves one fault at a time");
+        resumed = mm.servicePageFaults(1 + 2 * latency);
+        results.expect(resumed.size() == 1 && resumed[0] == second.get() && mm.getPendingFaultCount() == 0,
+            "the second fault completes a full latency after the first");
+
+        // Resumed, the instruction runs without faulting again
+        first->setStatus(ProcessStatus::Running);
+        first->executeInstruction();
+        results.expect(first->getRemainingInstructions() == 1 && mm.getBlockedFaultCount() == 2 &&
+            first->readMemoryValueAt(0x80) == 7, "the resumed instruction runs against the mapped pages");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkReadahead() {
+        Results results("code readahead");
+        const int frameSize = FRAME_SIZE;
+        const int numFrames = 16;
+        const int pages = 4;
+        MemorySettings settings;
+        settings.readaheadWindow = 4;
+        settings.pageFaultLatency = 1;   // Readahead only runs for blocking faults
+        MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, settings);
+
+        // A program long enough that its code spans more pages than there are frames
+        int instructions = 2 * numFrames * frameSize / static_cast<int>(sizeof(Instruction));
+        auto proc = std::make_shared<Process>("check-code", 1, instructions, pages * frameSize);
+        proc->setMemoryManager(&mm);
+        mm.registerProcess(proc);
+        const int start = proc->getCodeSegmentStart();
+        auto& pageTable = proc->getPageTable();
+
+        // Sequential faults double the window: one page after the first fault, two after the next
+        mm.allocatePage(proc.get(), start);
+        results.expect(mm.readaheadCode(proc.get(), start) == 1 && pageTable.isResident(start + 1),
+            "the first code fault reads one page ahead");
+        mm.allocatePage(proc.get(), start + 2);
+        results.expect(mm.readaheadCode(proc.get(), start + 2) == 2 && pageTable.isResident(start + 3) &&
+            pageTable.isResident(start + 4), "a sequential fault doubles the window");
+        results.expect(mm.getReadaheadPageCount() == 3 && mm.getFaultCount() == 2, "readahead pages are not counted as faults");
+
+        // A jump back (a loop's back-edge) halves the window
+        mm.readaheadCode(proc.get(), start);
+        results.expect(proc->getReadaheadState().window == 1, "a non-sequential fault shrinks the window");
+
+        // With no free frame, readahead maps nothing rather than evicting resident pages
+        auto other = attachProcess(mm, "check-other", 2, numFrames * frameSize);
+        for (int page = 0; mm.getFreeFrameCount() > 0; ++page) {
+            other->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), 1);
+        }
+        mm.allocatePage(proc.get(), start + 5);
+        int usedBefore = mm.getUsedFrameCount();
+        int pagedOutBefore = mm.getPagedOutCount();
+        results.expect(mm.readaheadCode(proc.get(), start + 5) == 0 && mm.getPagedOutCount() == pagedOutBefore &&
+            mm.getUsedFrameCount() == usedBefore, "readahead never evicts to make room");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkWorkingSet() {
+        Results results("working sets");
+        const int frameSize = FRAME_SIZE;
+        const int pages = 4;
+        MemoryManager mm(pages * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+        auto proc = attachProcess(mm, "check-ws", 1, pages * frameSize);
+
+        // Pages 0 and 1 are touched at tick 0, page 2 at tick 5 and page 3 at tick 10
+        auto touchAt = [&](Process& process, long long tick, int page) {
+            mm.servicePageFaults(tick);   // Nothing is queued; this only advances the manager's clock
+            process.setMemoryValueAt(static_cast<uint32_t>(page * frameSize), 1);
+        };
+        touchAt(*proc, 0, 0);
+        touchAt(*proc, 0, 1);
+        touchAt(*proc, 5, 2);
+        touchAt(*proc, 10, 3);
+        results.expect(mm.getWorkingSetSize(proc.get(), 1) == 1 && mm.getWorkingSetSize(proc.get(), 6) == 2 &&
+            mm.getWorkingSetSize(proc.get(), 11) == 4, "the window decides which references count");
+        touchAt(*proc, 12, 0);
+        results.expect(mm.getWorkingSetSize(proc.get(), 3) == 2, "a new reference brings a page back into the working set");
+        results.expect(mm.getResidentRatio(proc.get()) == 1.0, "every touched page is resident");
+
+        // Another process takes half the frames; its victims stay touched but are no longer resident
+        auto other = attachProcess(mm, "check-other", 2, pages * frameSize);
+        touchAt(*other, 13, 0);
+        touchAt(*other, 13, 1);
+        results.expect(mm.getResidentRatio(proc.get()) == 0.5, "evicted pages lower the resident ratio");
+        results.expect(mm.getWorkingSetSize(other.get(), 1) == 2, "a fresh process's working set is what it just touched");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkConcurrentFaults() {
+        Results results("concurrent faults");
+        const int frameSize = FRAME_SIZE;
+        const int cellsPerPage = frameSize / 2;
+        const int numFrames = 8;
+        const int threadCount = 4;
+        const int pagesPerProcess = 8;
+        const int operations = 1500;
+        MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+
+        std::vector<std::shared_ptr<Process>> processes;
+        for (int i = 0; i < threadCount; ++i) {
+            processes.push_back(attachProcess(mm, "check" + std::to_string(i), i, pagesPerProcess * frameSize));
+        }
+
+        // Each thread owns one process and checks every read against what it last wrote; together they
+        // want four times the frames, so most accesses fault and evict another thread's page
+        std::atomic<int> mismatches{ 0 };
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 rng(38 + t);
+                std::vector<uint16_t> expected(pagesPerProcess * cellsPerPage, 0);
+                Process& proc = *processes[t];
+                for (int n = 0; n < operations; ++n) {
+                    int cell = static_cast<int>(rng() % expected.size());
+                    uint32_t address = static_cast<uint32_t>(cell * 2);
+                    if (rng() % 2 == 0) {
+                        expected[cell] = static_cast<uint16_t>(t * 1000 + n % 1000 + 1);
+                        proc.setMemoryValueAt(address, expected[cell]);
+                    }
+                    else if (proc.readMemoryValueAt(address) != expected[cell]) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+
+        // The console's read paths run against the same tables without blocking the faulting threads
+        int snapshots = 0;
+        std::thread reader([&]() {
+            do {
+                MemorySnapshot snapshot = mm.captureSnapshot();
+                snapshots += snapshot.usedFrames <= numFrames ? 1 : 0;
+                processes[0]->getMemoryDump();
+            } while (!done);
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        done = true;
+        reader.join();
+
+        results.expect(mismatches == 0, std::to_string(mismatches.load()) + " read(s) saw a value that was not last written");
+        results.expect(mm.getPagedOutCount() > 0, "the threads forced evictions");
+        results.expect(snapshots > 0, "snapshots taken mid-run stay within the frame table");
+        results.expect(mm.getUsedFrameCount() == numFrames && mm.getFreeFrameCount() == 0, "no frame was lost or double-counted");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkPageTable() {
+        Results results("page table");
+        PageTable table;
+        results.expect(table.getLeafCount() == 0 && !table.find(0) && !table.isResident(0),
+            "an empty table has no leaves and no entries");
+
+        // Touching one page allocates only its leaf; its neighbours in the leaf start unmapped
+        const int far = 5 * PageTable::LEAF_SIZE + 3;
+        table.entryFor(far).frameNumber = 7;
+        table.entryFor(far).valid = true;
+        results.expect(table.getLeafCount() == 1, "the first touch allocates one leaf");
+        results.expect(!table.find(0) && !table.find(4 * PageTable::LEAF_SIZE), "untouched ranges stay unallocated");
+        results.expect(table.find(far - 1) && table.find(far - 1)->frameNumber == -1 && !table.isResident(far - 1),
+            "other entries in the leaf start unmapped");
+        results.expect(table.isResident(far) && table.find(far)->frameNumber == 7, "the touched entry is resident");
+        results.expect(!table.find(-1) && !table.find(100 * PageTable::LEAF_SIZE), "out-of-range pages find nothing");
+
+        table.entryFor(far + 1).frameNumber = 8;
+        table.entryFor(1).frameNumber = 9;
+        results.expect(table.getLeafCount() == 2, "a neighbour reuses its leaf and a new range adds one");
+        results.expect(!table.isResident(1), "a mapped but invalid page is not resident");
+
+        std::vector<std::pair<int, int>> mapped;
+        table.forEachMapped([&](int page, const PageTableEntry& entry) {
+            mapped.push_back({ page, entry.frameNumber });
+        });
+        results.expect(mapped == std::vector<std::pair<int, int>>{ { 1, 9 }, { far, 7 }, { far + 1, 8 } },
+            "mapped pages are visited once each, in page order");
+
+        // A copy owns its own leaves
+        PageTable copy = table;
+        copy.entryFor(far).frameNumber = 11;
+        results.expect(copy.getLeafCount() == 2 && table.find(far)->frameNumber == 7, "a copy does not share entries");
+
+        // A process declared large but touching two pages only grows two leaves
+        const int frameSize = FRAME_SIZE;
+        const int pages = 8 * PageTable::LEAF_SIZE;
+        MemoryManager mm(4 * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+        auto proc = attachProcess(mm, "check-pt", 1, pages * frameSize);
+        proc->setMemoryValueAt(0, 1);
+        proc->setMemoryValueAt(static_cast<uint32_t>((pages - 1) * frameSize), 2);
+        results.expect(proc->getPageTable().getLeafCount() == 2, "a sparse process allocates leaves only where it touched");
+        results.expect(proc->readMemoryValueAt(static_cast<uint32_t>((pages - 1) * frameSize)) == 2 &&
+            proc->readMemoryValueAt(0) == 1, "both ends of the address space read back");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkTlb() {
+        Results results("tlb");
+        const int hugePageFrames = 4;
+        TLB tlb(16, hugePageFrames);
+        tlb.switchTo(1);
+
+        tlb.insert(1, 5, 42, false);
+        results.expect(tlb.lookup(1, 5) == 42, "a cached page translates to its frame");
+        long long missesBefore = tlb.getMissCount();
+        results.expect(tlb.lookup(2, 5) == -1 && tlb.lookup(1, 6) == -1 && tlb.getMissCount() == missesBefore + 2,
+            "another process or page misses");
+
+        // Filling from any page of a huge page caches one entry that covers the whole run
+        tlb.insert(1, 9, 21, true);
+        long long hugeHitsBefore = tlb.getHugeHitCount();
+        for (int page = 8; page < 8 + hugePageFrames; ++page) {
+            results.expect(tlb.lookup(1, page) == 20 + page - 8,
+                "huge entry translates page " + std::to_string(page) + " to its offset in the run");
+        }
+        results.expect(tlb.getHugeHitCount() == hugeHitsBefore + hugePageFrames, "huge hits are counted");
+        results.expect(tlb.lookup(1, 12) == -1 && tlb.lookup(1, 7) == -1, "huge entry stops at its run");
+
+        // Evicting any one page of the run shoots the whole huge entry down, and nothing else
+        long long shootdownsBefore = tlb.getShootdownCount();
+        tlb.shootdown(1, 10);
+        bool runGone = true;
+        for (int page = 8; page < 8 + hugePageFrames; ++page) {
+            runGone = runGone && tlb.lookup(1, page) == -1;
+        }
+        results.expect(runGone, "a shootdown inside a huge page drops the covering entry");
+        results.expect(tlb.getShootdownCount() == shootdownsBefore + 1, "the shootdown is counted");
+        tlb.shootdown(1, 10);
+        results.expect(tlb.getShootdownCount() == shootdownsBefore + 1, "a shootdown with nothing to drop is not counted");
+        results.expect(tlb.lookup(1, 5) == 42, "a shootdown leaves unrelated entries");
+
+        // Refilling a page updates its one entry in place
+        tlb.insert(1, 5, 43, false);
+        results.expect(tlb.lookup(1, 5) == 43, "a refill replaces the old frame");
+        tlb.invalidate(1, 5);
+        results.expect(tlb.lookup(1, 5) == -1, "a refill does not leave a second, stale entry");
+
+        // A fifth page in a four-way set evicts the oldest way
+        for (int page : { 0, 4, 8, 12, 16 }) {
+            tlb.insert(1, page, 100 + page, false);
+        }
+        results.expect(tlb.lookup(1, 0) == -1, "a full set evicts its oldest entry");
+        bool othersKept = true;
+        for (int page : { 4, 8, 12, 16 }) {
+            othersKept = othersKept && tlb.lookup(1, page) == 100 + page;
+        }
+        results.expect(othersKept, "a full set keeps the rest of its entries");
+
+        // Redispatching the same process keeps its translations; a different one flushes them
+        long long flushesBefore = tlb.getFlushCount();
+        tlb.switchTo(1);
+        results.expect(tlb.getFlushCount() == flushesBefore && tlb.lookup(1, 4) == 104,
+            "switching to the same process keeps the TLB");
+        tlb.switchTo(2);
+        results.expect(tlb.getFlushCount() == flushesBefore + 1 && tlb.lookup(1, 4) == -1,
+            "switching to another process flushes the TLB");
+
+        // With huge pages off, a huge fill is an ordinary entry
+        TLB smallOnly(16, 1);
+        smallOnly.insert(1, 9, 21, true);
+        results.expect(smallOnly.lookup(1, 9) == 21 && smallOnly.lookup(1, 8) == -1,
+            "huge fills are plain entries when huge pages are off");
+
+        TLB disabled(0, hugePageFrames);
+        disabled.insert(1, 5, 42, false);
+        results.expect(!disabled.isEnabled() && disabled.lookup(1, 5) == -1 && disabled.getMissCount() == 0,
+            "a zero-entry TLB caches nothing");
+
+        return results.finish();
+    }
+
+    bool checkHugePages() {
+        Results results("huge pages");
+        const int frameSize = FRAME_SIZE;
+        const int hugeFrames = 4;
+        const int numFrames = 2 * hugeFrames;
+        MemorySettings settings;
+        settings.hugePageSize = hugeFrames * frameSize;
+        settings.hugePageThreshold = numFrames * frameSize;
+        MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, settings);
+        auto big = attachProcess(mm, "check-huge", 1, numFrames * frameSize);
+        auto small = attachProcess(mm, "check-small", 2, (numFrames - 1) * frameSize);
+
+        // One fault in a large process maps its whole aligned run onto aligned, contiguous frames
+        auto valueAt = [](int page) { return static_cast<uint16_t>(100 + page); };
+        big->setMemoryValueAt(static_cast<uint32_t>(1 * frameSize), valueAt(1));
+        results.expect(mm.getHugePageCount() == 1 && mm.getPagedInCount() == hugeFrames, "one fault maps a whole huge page");
+        const PageTable& table = big->getPageTable();
+        int base = table.find(0) ? static_cast<int>(table.find(0)->frameNumber) : -1;
+        bool contiguous = base >= 0 && base % hugeFrames == 0;
+        for (int page = 0; page < hugeFrames && contiguous; ++page) {
+            const PageTableEntry* entry = table.find(page);
+            contiguous = entry->valid && entry->huge && entry->frameNumber == base + page;
+        }
+        results.expect(contiguous, "the run sits on aligned, contiguous frames, all marked huge");
+        int faultsBefore = mm.getFaultCount();
+        for (int page = 0; page < hugeFrames; ++page) {
+            big->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), valueAt(page));
+        }
+        results.expect(mm.getFaultCount() == faultsBefore, "the rest of the run needs no faults");
+
+        // A process under the threshold gets base pages; a large one with no free aligned run falls back
+        small->setMemoryValueAt(0, 1);
+        results.expect(mm.getHugePageCount() == 1 && !small->getPageTable().find(0)->huge,
+            "a process under the threshold gets base pages");
+        big->setMemoryValueAt(static_cast<uint32_t>(hugeFrames * frameSize), valueAt(hugeFrames));
+        results.expect(mm.getHugeFallbackCount() == 1 && !table.find(hugeFrames)->huge,
+            "without a free aligned run the fault maps a base page");
+
+        // Cycling the small process through memory evicts the cold huge frames, which splits the run first
+        for (int pass = 0; pass < 3; ++pass) {
+            for (int page = 0; page < numFrames - 1; ++page) {
+                small->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), static_cast<uint16_t>(page + 1));
+            }
+        }
+        results.expect(mm.getHugeSplitCount() == 1, "evicting part of the huge page splits it");
+        bool noneHuge = true;
+        for (int page = 0; page < hugeFrames; ++page) {
+            const PageTableEntry* entry = table.find(page);
+            noneHuge = noneHuge && !entry->huge;
+        }
+        results.expect(noneHuge, "no page of a split run is still marked huge");
+        bool kept = true;
+        for (int page = 0; page <= hugeFrames; ++page) {
+            kept = big->readMemoryValueAt(static_cast<uint32_t>(page * frameSize)) == valueAt(page) && kept;
+        }
+        results.expect(kept, "every page of the split run keeps its contents");
+        results.expect(mm.getHugePageCount() == 1, "no huge page is mapped while memory is full");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkFork() {
+        Results results("fork/copy-on-write");
+        const int frameSize = FRAME_SIZE;
+        const int pages = 8;
+        const int numFrames = pages + pages / 2;   // Room for the parent's copies while everything is still shared
+        MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+
+        auto forkOf = [&](Process& source, const String& name, int id, int& shared) {
+            auto child = std::make_shared<Process>(source, name, id);
+            child->setMemoryManager(&mm);
+            mm.registerProcess(child);
+            shared = mm.forkAddressSpace(&source, child.get());
+            return child;
+        };
+        auto valueAt = [&](int page, int generation) { return static_cast<uint16_t>(1000 * generation + page + 1); };
+        auto writeAll = [&](Process& proc, std::vector<uint16_t>& values, int first, int step, int generation) {
+            for (int page = first; page < pages; page += step) {
+                values[page] = valueAt(page, generation);
+                proc.setMemoryValueAt(static_cast<uint32_t>(page * frameSize), values[page]);
+            }
+        };
+        auto readsBack = [&](Process& proc, const std::vector<uint16_t>& expected) {
+            bool same = true;
+            for (int page = 0; page < pages; ++page) {
+                same = proc.readMemoryValueAt(static_cast<uint32_t>(page * frameSize)) == expected[page] && same;
+            }
+            return same;
+        };
+
+        auto parent = attachProcess(mm, "check-parent", 1, pages * frameSize);
+        std::vector<uint16_t> parentValues(pages);
+        writeAll(*parent, parentValues, 0, 1, 1);
+
+        int shared = 0;
+        auto child = forkOf(*parent, "check-child", 2, shared);
+        results.expect(shared == pages, "every resident page is shared, not copied");
+        std::vector<uint16_t> childValues = parentValues;
+
+        // Writes on either side break the sharing for that page only
+        int cowFaultsBefore = mm.getCowFaultCount();
+        writeAll(*parent, parentValues, 1, 2, 2);
+        writeAll(*child, childValues, 0, 2, 3);
+        results.expect(mm.getCowFaultCount() > cowFaultsBefore, "a write to a shared page takes a copy-on-write fault");
+        results.expect(readsBack(*child, childValues), "the parent's writes do not reach the child");
+        results.expect(readsBack(*parent, parentValues), "the child's writes do not reach the parent");
+
+        // Push everything out through a third process and read both copies back in
+        auto other = attachProcess(mm, "check-other", 3, pages * frameSize);
+        std::vector<uint16_t> otherValues(pages);
+        writeAll(*other, otherValues, 0, 1, 4);
+        results.expect(readsBack(*parent, parentValues) && readsBack(*child, childValues),
+            "both copies survive eviction and reload");
+
+        // Under pressure only part of the parent is resident; the rest is copied to the child's own slots
+        writeAll(*other, otherValues, 0, 1, 5);
+        auto grandchild = forkOf(*parent, "check-grandchild", 6, shared);
+        results.expect(shared < pages, "swapped-out pages are copied, not shared");
+        results.expect(readsBack(*grandchild, parentValues), "a fork under memory pressure sees every parent page");
+
+        // A parent forked mid-sleep hands its child the rest of the sleep
+        auto sleeper = std::make_shared<Process>("check-sleeper", 4, 2, pages * frameSize, "SLEEP 5; DECLARE x 1");
+        sleeper->setMemoryManager(&mm);
+        mm.registerProcess(sleeper);
+        sleeper->executeInstruction();
+        sleeper->executeInstruction();
+        Process sleepyChild(*sleeper, "check-sleepy-child", 5);
+        results.expect(sleeper->getStatus() == ProcessStatus::Sleeping && sleepyChild.getStatus() == ProcessStatus::Sleeping,
+            "a child forked from a sleeping parent starts Sleeping");
+        results.expect(sleepyChild.getSleepCyclesRemaining() == sleeper->getSleepCyclesRemaining() &&
+            sleepyChild.getSleepCyclesRemaining() == 4, "the child inherits the sleep left");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkSharedCode() {
+        Results results("shared code");
+        const int frameSize = FRAME_SIZE;
+        const int dataPages = 4;
+        const int numFrames = 4;
+        const int seed = 44044;
+        MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+
+        auto running = [&](const String& name, int id, int programSeed) {
+            auto proc = std::make_shared<Process>(name, id, 20, dataPages * frameSize, "", programSeed);
+            proc->setMemoryManager(&mm);
+            mm.registerProcess(proc);
+            return proc;
+        };
+        auto first = running("check-code-a", 1, seed);
+        auto second = running("check-code-b", 2, seed);
+        auto other = running("check-code-c", 3, seed + 1);
+        const int codePage = first->getCodeSegmentStart();
+
+        // The first process to fault a code page loads it; another running the same program maps that frame
+        int frame = mm.allocatePage(first.get(), codePage);
+        int faultsBefore = mm.getFaultCount();
+        results.expect(mm.tryMapSharedCode(second.get(), codePage), "the same program maps the resident code page");
+        results.expect(second->getPageTable().find(codePage)->frameNumber == frame && mm.getSharedCodeMapCount() == 1 &&
+            mm.getFaultCount() == faultsBefore && mm.getUsedFrameCount() == 1, "the mapping is a minor fault onto the same frame");
+        results.expect(mm.captureSnapshot().sharedCodeFrames == 1, "the snapshot counts the shared frame");
+        results.expect(!mm.tryMapSharedCode(other.get(), codePage), "a different program never maps it");
+        results.expect(!mm.tryMapSharedCode(second.get(), 0), "data pages are never shared");
+
+        // Evicting the frame drops every mapping and its published entry; the next load publishes afresh
+        auto data = attachProcess(mm, "check-data", 4, 2 * numFrames * frameSize);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int page = 0; page < 2 * numFrames; ++page) {
+                data->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), static_cast<uint16_t>(page + 1));
+            }
+        }
+        results.expect(!first->getPageTable().isResident(codePage) && !second->getPageTable().isResident(codePage),
+            "evicting a shared code frame unmaps it from every process");
+        results.expect(!mm.tryMapSharedCode(first.get(), codePage), "an evicted code page is no longer offered");
+        frame = mm.allocatePage(second.get(), codePage);
+        results.expect(mm.tryMapSharedCode(first.get(), codePage) && first->getPageTable().find(codePage)->frameNumber == frame,
+            "a reload is shared again");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkMerge() {
+        Results results("same-page merging");
+        const int frameSize = FRAME_SIZE;
+        const int processCount = 3;
+        const int pages = 4;
+        const int numFrames = 16;
+
+        // Huge pages must stay contiguous, so identical pages inside one are never merged
+        {
+            MemorySettings settings;
+            settings.hugePageSize = pages * frameSize;
+            settings.hugePageThreshold = pages * frameSize;
+            MemoryManager hugeMm(numFrames * frameSize, frameSize, SCRATCH_STORE, settings);
+            auto proc = attachProcess(hugeMm, "check-huge", 0, pages * frameSize);
+            proc->setMemoryValueAt(0, 77);
+            proc->setMemoryValueAt(static_cast<uint32_t>(frameSize), 77);
+            results.expect(hugeMm.getHugePageCount() == 1, "the process is mapped with a huge page");
+            results.expect(hugeMm.scanForDuplicatePages(numFrames * 2) == 0 && hugeMm.getMergeCount() == 0,
+                "pages inside a huge page are never merged");
+        }
+        std::remove(SCRATCH_STORE.c_str());
+
+        MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+
+        // Pages 0 and 1 of every process hold the same image; pages 2 and 3 are each their own
+        std::vector<std::shared_ptr<Process>> processes;
+        std::vector<std::vector<uint16_t>> expected(processCount, std::vector<uint16_t>(pages));
+        for (int i = 0; i < processCount; ++i) {
+            auto proc = attachProcess(mm, "check" + std::to_string(i), i, pages * frameSize);
+            processes.push_back(proc);
+            for (int page = 0; page < pages; ++page) {
+                expected[i][page] = static_cast<uint16_t>(page < 2 ? 77 : 100 * (i + 1) + page);
+                proc->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), expected[i][page]);
+            }
+        }
+        auto readsBack = [&]() {
+            bool same = true;
+            for (int i = 0; i < processCount; ++i) {
+                for (int page = 0; page < pages; ++page) {
+                    same = processes[i]->readMemoryValueAt(static_cast<uint32_t>(page * frameSize)) == expected[i][page] && same;
+                }
+            }
+            return same;
+        };
+
+        // A frame must hash the same on two passes before it is merged
+        int usedBefore = mm.getUsedFrameCount();
+        results.expect(mm.scanForDuplicatePages(numFrames) == 0, "the first pass only records checksums");
+        int duplicates = processCount * 2 - 1;
+        results.expect(mm.scanForDuplicatePages(numFrames) == duplicates, "the second pass merges every duplicate");
+        results.expect(mm.getUsedFrameCount() == usedBefore - duplicates && mm.getMergeCount() == duplicates,
+            "merged duplicates give their frames back");
+        results.expect(mm.scanForDuplicatePages(numFrames) == 0, "a merged page is not merged again");
+        results.expect(readsBack(), "every process still reads its own pages after merging");
+
+        // Writing a merged page gives the writer a private copy and leaves the other mappings alone
+        int unmergesBefore = mm.getUnmergeCount();
+        expected[0][0] = 99;
+        processes[0]->setMemoryValueAt(0, expected[0][0]);
+        results.expect(mm.getUnmergeCount() == unmergesBefore + 1, "a write to a merged page unmerges it");
+        results.expect(readsBack(), "a write to a merged page reaches only the writer");
+
+        // Process 1 maps the merged frame at pages 0 and 1; a reference stamps the page that made it
+        int mergedFrame = processes[1]->getPageTable().find(0)->frameNumber;
+        mm.servicePageFaults(5);
+        mm.markPageAccessed(mergedFrame, processes[1].get(), 1);
+        results.expect(processes[1]->getPageTable().find(1)->lastUseTick == 5 &&
+            processes[1]->getPageTable().find(0)->lastUseTick < 5, "a reference stamps the mapping that made it");
+
+        // Once every other mapping has its own copy, the last one holds an ordinary frame
+        for (int i = 0; i < processCount; ++i) {
+            for (int page = 0; page < 2; ++page) {
+                if (processes[i]->getPageTable().find(page)->frameNumber == mergedFrame && (i != processCount - 1 || page != 1)) {
+                    expected[i][page] = static_cast<uint16_t>(50 + i * 2 + page);
+                    processes[i]->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), expected[i][page]);
+                }
+            }
+        }
+        results.expect(mm.captureSnapshot().mergedFrames == 0 && !processes[processCount - 1]->getPageTable().find(1)->cow,
+            "a merged frame left with one mapping is no longer merged");
+        results.expect(readsBack(), "unmerged copies keep their own writes");
+
+        // Merged and unmerged pages alike survive eviction and reload
+        auto other = attachProcess(mm, "check-other", processCount, numFrames * frameSize);
+        for (int page = 0; page < numFrames; ++page) {
+            other->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), static_cast<uint16_t>(page + 1));
+        }
+        results.expect(readsBack(), "merged pages survive eviction and reload");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkSwapping() {
+        Results results("whole-process swapping");
+        const int frameSize = FRAME_SIZE;
+        const int pages = 6;
+        const int numFrames = 8;
+        MemoryManager mm(numFrames * frameSize, frameSize, SCRATCH_STORE, MemorySettings{});
+        auto proc = attachProcess(mm, "check-swap", 1, pages * frameSize);
+        auto bystander = attachProcess(mm, "check-stay", 2, 2 * frameSize);
+
+        // Pages 0-3 hold data, page 4 is resident but all zero, and page 5 was never touched
+        std::vector<uint16_t> expected(pages, 0);
+        for (int page = 0; page < 4; ++page) {
+            expected[page] = static_cast<uint16_t>(460 + page);
+            proc->setMemoryValueAt(static_cast<uint32_t>(page * frameSize), expected[page]);
+        }
+        proc->setMemoryValueAt(static_cast<uint32_t>(4 * frameSize), 0);
+        bystander->setMemoryValueAt(0, 7);
+        auto readsBack = [&](Process& p, int pageCount) {
+            bool same = true;
+            for (int page = 0; page < pageCount; ++page) {
+                same = p.readMemoryValueAt(static_cast<uint32_t>(page * frameSize)) == expected[page] && same;
+            }
+            return same;
+        };
+
+        // Swap-out frees every resident frame in one batch write, dropping the zero page instead of writing it
+        results.expect(mm.swapOutProcess(proc.get()) == 5 && mm.getUsedFrameCount() == 1, "swap-out frees every resident frame");
+        bool noneResident = true;
+        for (int page = 0; page < pages; ++page) {
+            noneResident = noneResident && !proc->getPageTable().isResident(page);
+        }
+        results.expect(noneResident, "no page stays mapped after swap-out");
+        results.expect(mm.getSwapOutWriteCount() == 4 && mm.getSwappedOutPageCount() == 5, "only non-zero pages are written");
+        results.expect(bystander->readMemoryValueAt(0) == 7, "other processes keep their pages");
+
+        // Swap-in maps the same pages back in one batch, with no faults
+        int faultsBefore = mm.getFaultCount();
+        results.expect(mm.swapInProcess(proc.get()) == 5 && mm.getSwappedInPageCount() == 5, "swap-in maps back what was resident");
+        results.expect(!proc->getPageTable().isResident(5), "a never-touched page stays unmapped");
+        results.expect(mm.swapInProcess(proc.get()) == 0, "a second swap-in has nothing to do");
+        results.expect(readsBack(*proc, pages - 1) && mm.getFaultCount() == faultsBefore, "every swapped-in page reads back without a fault");
+
+        // A frame shared with a fork stays resident for the child; the parent just drops its mapping
+        auto child = std::make_shared<Process>(*proc, "check-swap-child", 3);
+        child->setMemoryManager(&mm);
+        mm.registerProcess(child);
+        mm.forkAddressSpace(proc.get(), child.get());
+        int usedBefore = mm.getUsedFrameCount();
+        results.expect(mm.swapOutProcess(proc.get()) == 0 && mm.getUsedFrameCount() == usedBefore,
+            "frames shared with a fork are not freed");
+        results.expect(readsBack(*child, pages), "the child keeps reading the shared pages");
+        mm.swapInProcess(proc.get());
+        results.expect(readsBack(*proc, pages), "the parent's pages survive its swap-out from shared frames");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+}
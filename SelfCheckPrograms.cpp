@@ -0,0 +1,52 @@
+#include "SelfCheck.h"
+#include "SelfCheckFixture.h"
+#include "ProgramCache.h"
+#include <memory>
+#include <stdexcept>
+
+namespace SelfCheck {
+    bool checkProgramImages() {
+        Results results("program images");
+
+        // The same text and padding decode once; different padding is a different image
+        const String text = "DECLARE x 5; ADD x x 1; PRINT(\"done\")";
+        int hitsBefore = ProgramCache::getHitCount();
+        auto parsed = ProgramCache::parse(text, 8);
+        results.expect(ProgramCache::parse(text, 8) == parsed && ProgramCache::getHitCount() > hitsBefore,
+            "identical text is served from the cache");
+        results.expect(ProgramCache::parse(text, 9) != parsed, "a different padded length is its own image");
+        results.expect(parsed->lineCount == 3 && static_cast<int>(parsed->instructions.size()) >= 8,
+            "a parsed image keeps its line count and is padded");
+        bool rejected = false;
+        try {
+            ProgramCache::parse("", 8);
+        }
+        catch (const std::runtime_error& e) {
+            rejected = String(e.what()) == "invalid command";
+        }
+        results.expect(rejected, "an empty program is rejected as an invalid command");
+
+        // Generated programs share by seed, length and memory size
+        const uint32_t seed = 43043;
+        auto generated = ProgramCache::generate(seed, 20, 256);
+        results.expect(ProgramCache::generate(seed, 20, 256) == generated, "the same seed and parameters share an image");
+        results.expect(ProgramCache::generate(seed + 1, 20, 256) != generated && ProgramCache::generate(seed, 21, 256) != generated,
+            "a different seed or length is its own image");
+
+        // Processes built from one seed run one image, and it is freed with the last of them
+        std::weak_ptr<const ProgramImage> shared;
+        {
+            Process first("check-prog-a", 1, 20, 256, "", static_cast<int>(seed) + 2);
+            Process second("check-prog-b", 2, 20, 256, "", static_cast<int>(seed) + 2);
+            results.expect(&first.getProgram() == &second.getProgram(), "processes with the same seed share their program");
+            Process child(first, "check-prog-c", 3);
+            results.expect(&child.getProgram() == &first.getProgram(), "a forked child runs its parent's image");
+            shared = ProgramCache::generate(seed + 2, 20, 256);
+            results.expect(shared.lock().get() == &first.getProgram(), "the cache hands out the image the processes run");
+        }
+        results.expect(shared.expired(), "the image is freed with the last process using it");
+        results.expect(ProgramCache::pickSeed() >= 0, "a picked seed is never negative");
+
+        return results.finish();
+    }
+}
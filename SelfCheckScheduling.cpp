@@ -0,0 +1,177 @@
+#include "SelfCheck.h"
+#include "SelfCheckFixture.h"
+#include "Scheduler.h"
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace SelfCheck {
+    bool checkLocalityPick() {
+        Results results("locality pick");
+        using Candidate = CPUScheduler::LocalityCandidate;
+        const int maxSkips = 3;
+        auto ready = [](double ratio, int skips = 0) {
+            Candidate candidate;
+            candidate.ready = true;
+            candidate.residentRatio = ratio;
+            candidate.skips = skips;
+            return candidate;
+        };
+
+        results.expect(CPUScheduler::pickByLocality({ ready(0.2), ready(0.9), ready(0.5) }, maxSkips) == 1,
+            "the process with the most pages resident goes first");
+        results.expect(CPUScheduler::pickByLocality({ ready(0.5), ready(0.5), ready(0.5) }, maxSkips) == 0,
+            "ties keep queue order");
+        results.expect(CPUScheduler::pickByLocality({ Candidate{}, ready(0.1), Candidate{}, ready(0.4) }, maxSkips) == 3,
+            "stale entries are never picked");
+        Candidate staleButResident;
+        staleButResident.residentRatio = 1.0;
+        results.expect(CPUScheduler::pickByLocality({ staleButResident, ready(0.0) }, maxSkips) == 1,
+            "a stale entry's resident pages do not count");
+        results.expect(CPUScheduler::pickByLocality({ Candidate{}, Candidate{} }, maxSkips) == 0,
+            "with nothing ready the front entry is taken");
+
+        // A process passed over too often is dispatched ahead of better-placed ones
+        results.expect(CPUScheduler::pickByLocality({ ready(0.9), ready(0.1, maxSkips), ready(1.0) }, maxSkips) == 1,
+            "a process at its skip limit goes ahead of everyone");
+        results.expect(CPUScheduler::pickByLocality({ ready(0.1, maxSkips - 1), ready(0.9) }, maxSkips) == 1,
+            "a process under its skip limit can still be passed over");
+
+        // Passing over a ready process repeatedly reaches the limit within maxSkips dispatches
+        std::vector<Candidate> queue = { ready(0.0), ready(1.0), ready(1.0), ready(1.0), ready(1.0) };
+        int dispatches = 0;
+        while (CPUScheduler::pickByLocality(queue, maxSkips) != 0) {
+            size_t pick = CPUScheduler::pickByLocality(queue, maxSkips);
+            queue[0].skips++;
+            queue.erase(queue.begin() + pick);
+            dispatches++;
+        }
+        results.expect(dispatches == maxSkips, "a cold process waits at most maxSkips dispatches");
+
+        return results.finish();
+    }
+
+    bool checkCoreAffinity() {
+        Results results("core affinity");
+        const int penalty = 3;
+        Process proc("check-affinity", 1, 1, 64);
+
+        // The first dispatch and redispatches to the same core are free
+        results.expect(!proc.noteDispatch(0, penalty) && proc.getLastCore() == 0 && !proc.consumeWarmupTick(),
+            "the first dispatch is not a migration");
+        results.expect(!proc.noteDispatch(0, penalty) && proc.getMigrationCount() == 0 && !proc.consumeWarmupTick(),
+            "returning to the same core keeps the cache warm");
+
+        // Moving to another core stalls the process for the penalty, one tick at a time
+        results.expect(proc.noteDispatch(1, penalty) && proc.getLastCore() == 1 && proc.getMigrationCount() == 1,
+            "a dispatch to another core is a migration");
+        int stalled = 0;
+        while (proc.consumeWarmupTick()) {
+            stalled++;
+        }
+        results.expect(stalled == penalty, "a migration stalls for exactly the penalty");
+
+        // A second move mid-warmup restarts the stall rather than adding to it
+        proc.noteDispatch(2, penalty);
+        proc.consumeWarmupTick();
+        proc.noteDispatch(3, penalty);
+        stalled = 0;
+        while (proc.consumeWarmupTick()) {
+            stalled++;
+        }
+        results.expect(stalled == penalty && proc.getMigrationCount() == 3, "a migration mid-warmup restarts the stall");
+
+        results.expect(proc.noteDispatch(0, 0) && !proc.consumeWarmupTick(), "a zero penalty counts the migration but never stalls");
+
+        return results.finish();
+    }
+
+    bool checkLoadBalancing() {
+        Results results("load balancing");
+        using Load = CPUScheduler::RunQueueLoad;
+
+        // One core's load: a running process (if any) and its queued processes with their work left
+        auto load = [](bool running, const std::vector<std::pair<String, long long>>& queued) {
+            Load core;
+            core.length = (running ? 1 : 0) + static_cast<int>(queued.size());
+            core.work = running ? 10 : 0;
+            for (const auto& process : queued) {
+                core.work += process.second;
+            }
+            core.movable = queued;
+            return core;
+        };
+        // Queue lengths after the planned moves are applied
+        auto lengthsAfter = [](const std::vector<Load>& loads, const std::vector<CPUScheduler::BalanceMove>& moves) {
+            std::vector<int> lengths;
+            for (const Load& core : loads) {
+                lengths.push_back(core.length);
+            }
+            for (const auto& move : moves) {
+                lengths[move.fromCore]--;
+                lengths[move.toCore]++;
+            }
+            return lengths;
+        };
+
+        std::vector<Load> loads = { load(true, { { "a", 100 }, { "b", 100 }, { "c", 100 }, { "d", 100 } }), load(false, {}) };
+        auto moves = CPUScheduler::planLoadBalance(loads, 2, 0);
+        results.expect(moves.size() == 2 && lengthsAfter(loads, moves) == std::vector<int>({ 3, 2 }),
+            "a long queue sheds processes until the gap is under the threshold");
+        bool fromBusiest = true;
+        for (const auto& move : moves) {
+            fromBusiest = fromBusiest && move.fromCore == 0 && move.toCore == 1;
+        }
+        results.expect(fromBusiest, "processes move from the busiest core to the idlest");
+
+        loads = { load(true, { { "a", 100 } }), load(true, {}) };
+        results.expect(CPUScheduler::planLoadBalance(loads, 1, 0).empty(), "a one-process gap is left alone");
+        results.expect(CPUScheduler::planLoadBalance({ loads[0] }, 2, 1).empty(), "a single core has nothing to balance");
+
+        // Equal queue lengths but lopsided work: the queued process that best halves the gap moves
+        loads = { load(true, { { "short", 600 }, { "long", 4000 } }), load(true, { { "tiny", 10 } }) };
+        moves = CPUScheduler::planLoadBalance(loads, 2, 1000);
+        results.expect(moves.size() == 1 && moves[0].processName == "short" && moves[0].toCore == 1,
+            "a work imbalance moves the process that evens the cores out best");
+        results.expect(CPUScheduler::planLoadBalance(loads, 2, 0).empty(), "a work threshold of 0 turns work balancing off");
+
+        // A move that would only flip the imbalance is not made
+        loads = { load(true, { { "long", 5000 } }), load(true, {}) };
+        results.expect(CPUScheduler::planLoadBalance(loads, 2, 1000).empty(), "a move that only flips the imbalance is skipped");
+
+        // Only queued processes move; a core's running process stays put
+        loads = { load(true, {}), load(false, {}), load(false, {}) };
+        loads[0].length = 3;   // Queued entries that are not ready count toward length but cannot move
+        results.expect(CPUScheduler::planLoadBalance(loads, 2, 0).empty(), "nothing moves when nothing is movable");
+
+        // Many cores settle with every queue within one process of the others
+        std::vector<std::pair<String, long long>> queued;
+        for (int i = 0; i < 12; ++i) {
+            queued.emplace_back("p" + std::to_string(i), 100 + i);
+        }
+        loads = { load(true, queued), load(true, {}), load(false, {}), load(false, {}) };
+        auto lengths = lengthsAfter(loads, CPUScheduler::planLoadBalance(loads, 2, 0));
+        results.expect(*std::max_element(lengths.begin(), lengths.end()) - *std::min_element(lengths.begin(), lengths.end()) <= 1,
+            "four cores settle within one process of each other");
+
+        // Applying a plan moves each process to the back of its new queue and keeps the rest in order
+        loads = { load(false, { { "a", 100 }, { "b", 100 }, { "c", 100 }, { "d", 100 } }), load(false, {}) };
+        moves = CPUScheduler::planLoadBalance(loads, 2, 0);
+        std::vector<std::deque<String>> queues = { { "a", "b", "c", "d" }, {} };
+        results.expect(CPUScheduler::applyLoadBalance(queues, moves) == 2 && queues[0].size() == 2 && queues[1].size() == 2,
+            "every planned move is applied");
+        bool inOrder = std::is_sorted(queues[0].begin(), queues[0].end());
+        for (size_t i = 0; i < moves.size(); ++i) {
+            inOrder = inOrder && queues[1][i] == moves[i].processName;
+        }
+        results.expect(inOrder, "moved processes join the back in plan order and the rest keep theirs");
+
+        // A process that left its queue after planning (dispatched, finished) is not moved or resurrected
+        queues = { { "a", "b", "c", "d" }, {} };
+        queues[0].erase(std::find(queues[0].begin(), queues[0].end(), moves[0].processName));
+        results.expect(CPUScheduler::applyLoadBalance(queues, moves) == 1 && queues[0].size() == 2 && queues[1].size() == 1 &&
+            queues[1][0] == moves[1].processName, "a move whose process is no longer queued is skipped");
+
+        return results.finish();
+    }
+}
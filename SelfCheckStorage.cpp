@@ -0,0 +1,244 @@
+#include "SelfCheck.h"
+#include "SelfCheckFixture.h"
+#include "BackingStore.h"
+#include "CompressedPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace SelfCheck {
+    bool checkBackingStore() {
+        Results results("backing store");
+        const int pageSize = 64;
+
+        for (int queueCapacity : { 0, 8 }) {
+            String mode = queueCapacity > 0 ? " (write-behind)" : " (synchronous)";
+            BackingStore store(SCRATCH_STORE, pageSize, queueCapacity);
+
+            for (int page = 0; page < 4; ++page) {
+                store.writePage(1, page, makePage(pageSize, page).data());
+            }
+
+            // Queued or on disk, a page-in returns the newest image
+            store.writePage(1, 2, makePage(pageSize, 20).data());
+            std::vector<uint8_t> read(pageSize);
+            results.expect(store.readPage(1, 2, read.data()) && read == makePage(pageSize, 20),
+                "rewritten page reads back its newest image" + mode);
+
+            // A discarded page's slot is the next one handed out, and the file does not grow
+            int freedSlot = store.getSlot(1, 1);
+            int slotsBefore = store.getSlotCount();
+            store.discardPage(1, 1);
+            results.expect(!store.hasPage(1, 1) && !store.readPage(1, 1, read.data()),
+                "discarded page is gone" + mode);
+            store.writePage(2, 0, makePage(pageSize, 100).data());
+            results.expect(store.getSlot(2, 0) == freedSlot && store.getSlotCount() == slotsBefore,
+                "new page reuses the discarded slot" + mode);
+
+            store.flush();
+            for (int page : { 0, 3 }) {
+                results.expect(store.readPage(1, page, read.data()) && read == makePage(pageSize, page),
+                    "page " + std::to_string(page) + " survives a flush" + mode);
+            }
+            results.expect(store.readPage(2, 0, read.data()) && read == makePage(pageSize, 100),
+                "page in a reused slot reads back its own image" + mode);
+
+            // A batch of a process's pages moves onto one run of consecutive slots
+            std::vector<int> batchPages = { 0, 2, 3, 5, 6 };
+            std::vector<uint8_t> batch;
+            for (int page : batchPages) {
+                std::vector<uint8_t> image = makePage(pageSize, 200 + page);
+                batch.insert(batch.end(), image.begin(), image.end());
+            }
+            store.writePages(3, batchPages, batch.data());
+            store.flush();
+            bool consecutive = true;
+            for (size_t i = 1; i < batchPages.size(); ++i) {
+                consecutive = consecutive && store.getSlot(3, batchPages[i]) == store.getSlot(3, batchPages[0]) + static_cast<int>(i);
+            }
+            results.expect(consecutive, "batched write lands on consecutive slots" + mode);
+
+            // Reading the run back is one merged read, and each page still lands in its own buffer
+            std::vector<std::vector<uint8_t>> buffers(batchPages.size(), std::vector<uint8_t>(pageSize));
+            std::vector<uint8_t*> dest;
+            for (auto& buffer : buffers) {
+                dest.push_back(buffer.data());
+            }
+            std::vector<int> wanted = batchPages;
+            wanted.push_back(7);   // Never written
+            dest.push_back(read.data());
+            std::vector<bool> found;
+            int coalescedBefore = store.getCoalescedReadCount();
+            int foundCount = store.readPages(3, wanted, dest, found);
+            results.expect(foundCount == static_cast<int>(batchPages.size()) && !found.back(),
+                "batched read finds exactly the written pages" + mode);
+            for (size_t i = 0; i < batchPages.size(); ++i) {
+                results.expect(found[i] && buffers[i] == makePage(pageSize, 200 + batchPages[i]),
+                    "batched read returns page " + std::to_string(batchPages[i]) + mode);
+            }
+            results.expect(store.getCoalescedReadCount() - coalescedBefore == static_cast<int>(batchPages.size()) - 1,
+                "consecutive slots come in with one read" + mode);
+        }
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkWriteBehind() {
+        Results results("write-behind pager");
+        const int pageSize = 64;
+        const int threadCount = 6;
+        const int processCount = 3;
+        const int pages = 4;
+        const int operations = 3000;
+
+        // Every (process, page) has one fill byte, so a read served from a recycled slot shows up
+        auto fillOf = [](int process, int page) { return static_cast<uint8_t>(process * 16 + page + 1); };
+        for (int queueCapacity : { 0, 8 }) {
+            String mode = queueCapacity > 0 ? " (write-behind)" : " (synchronous)";
+            BackingStore store(SCRATCH_STORE, pageSize, queueCapacity);
+            std::atomic<int> wrongImages{ 0 };
+            std::vector<std::thread> threads;
+            for (int t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&, t]() {
+                    std::mt19937 rng(31 + t);
+                    std::vector<uint8_t> image(pageSize);
+                    for (int n = 0; n < operations; ++n) {
+                        int process = static_cast<int>(rng() % processCount);
+                        int page = static_cast<int>(rng() % pages);
+                        switch (rng() % 3) {
+                        case 0:
+                            store.discardPage(process, page);
+                            break;
+                        case 1:
+                            std::fill(image.begin(), image.end(), fillOf(process, page));
+                            store.writePage(process, page, image.data());
+                            break;
+                        default:
+                            if (store.readPage(process, page, image.data()) &&
+                                std::any_of(image.begin(), image.end(), [&](uint8_t b) { return b != fillOf(process, page); })) {
+                                wrongImages++;
+                            }
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            results.expect(wrongImages == 0, std::to_string(wrongImages.load()) + " read(s) returned another page's image" + mode);
+
+            // Once the queue drains, each surviving page has its own slot and its own image
+            store.flush();
+            int surviving = 0;
+            bool intact = true;
+            std::vector<uint8_t> image(pageSize);
+            for (int process = 0; process < processCount; ++process) {
+                for (int page = 0; page < pages; ++page) {
+                    if (!store.hasPage(process, page)) {
+                        continue;
+                    }
+                    surviving++;
+                    intact = intact && store.readPage(process, page, image.data()) &&
+                        std::all_of(image.begin(), image.end(), [&](uint8_t b) { return b == fillOf(process, page); });
+                }
+            }
+            results.expect(intact, "every surviving page reads back its own image after a flush" + mode);
+            results.expect(store.getUsedSlotCount() == surviving && store.getSlotCount() <= processCount * pages,
+                "discarded slots are reused rather than leaked" + mode);
+        }
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+
+    bool checkCompressedPool() {
+        Results results("compressed pool");
+        const int pageSize = 64;
+        BackingStore store(SCRATCH_STORE, pageSize, 0);
+
+        // A page built word by word, since the codec works on uint16 cells
+        auto fromWords = [&](auto wordAt) {
+            std::vector<uint8_t> page(pageSize);
+            for (int i = 0; i < pageSize / 2; ++i) {
+                uint16_t word = static_cast<uint16_t>(wordAt(i));
+                std::memcpy(&page[i * 2], &word, sizeof(word));
+            }
+            return page;
+        };
+
+        struct Pattern {
+            const char* name;
+            std::vector<uint8_t> page;
+        };
+        std::vector<Pattern> patterns = {
+            { "same-value", fromWords([](int) { return 0xBEEF; }) },
+            { "run-length", fromWords([](int i) { return i / 8 + 1; }) },
+            { "arithmetic", fromWords([](int i) { return 1000 + 3 * i; }) },
+            { "wrapping arithmetic", fromWords([](int i) { return 65530 + 7 * i; }) },
+            { "two-step arithmetic", fromWords([](int i) { return i < 16 ? 5 * i : 80 - 2 * (i - 16); }) },
+        };
+
+        CompressedPool pool(store, pageSize, 4096);
+        std::vector<uint8_t> read(pageSize);
+        for (size_t n = 0; n < patterns.size(); ++n) {
+            const Pattern& pattern = patterns[n];
+            int page = static_cast<int>(n);
+            String mode = String(" (") + pattern.name + ")";
+            results.expect(pool.store(1, page, pattern.page.data()), "page is accepted" + mode);
+            results.expect(pool.getUsedBytes() <= static_cast<int>(n + 1) * pageSize * 3 / 4,
+                "page shrinks by at least a quarter" + mode);
+
+            // peek leaves the entry; load hands it back and removes it
+            std::fill(read.begin(), read.end(), 0);
+            results.expect(pool.peek(1, page, read.data()) && read == pattern.page && pool.contains(1, page),
+                "peek decodes the page and keeps it" + mode);
+        }
+        for (size_t n = 0; n < patterns.size(); ++n) {
+            int page = static_cast<int>(n);
+            String mode = String(" (") + patterns[n].name + ")";
+            std::fill(read.begin(), read.end(), 0);
+            results.expect(pool.load(1, page, read.data()) && read == patterns[n].page && !pool.contains(1, page),
+                "load decodes the page and removes it" + mode);
+        }
+        results.expect(pool.getUsedBytes() == 0 && pool.getStoredPageCount() == 0, "an emptied pool holds no bytes");
+
+        // Noise does not compress, so it is refused and left for the backing store
+        std::mt19937 rng(36);
+        std::vector<uint8_t> noise = fromWords([&](int) { return rng(); });
+        int rejectsBefore = pool.getRejectCount();
+        results.expect(!pool.store(1, 0, noise.data()) && !pool.contains(1, 0) && pool.getRejectCount() == rejectsBefore + 1,
+            "incompressible page is rejected");
+
+        // Storing over a key replaces the old image rather than keeping both
+        pool.store(2, 0, patterns[1].page.data());
+        pool.store(2, 0, patterns[2].page.data());
+        results.expect(pool.getStoredPageCount() == 1 && pool.load(2, 0, read.data()) && read == patterns[2].page,
+            "a page stored twice keeps only its newest image");
+
+        // A full pool pushes its oldest page down to the file with its contents intact
+        CompressedPool small(store, pageSize, 3 * 4);   // Four same-value pages of three bytes each
+        for (int page = 0; page < 5; ++page) {
+            small.store(3, page, fromWords([&](int) { return 100 + page; }).data());
+        }
+        results.expect(small.getSpillCount() == 1 && !small.contains(3, 0) && small.contains(3, 4),
+            "a full pool spills its oldest page");
+        results.expect(store.readPage(3, 0, read.data()) && read == fromWords([](int) { return 100; }),
+            "a spilled page reads back from the backing store");
+        for (int page = 1; page < 5; ++page) {
+            results.expect(small.load(3, page, read.data()) && read == fromWords([&](int) { return 100 + page; }),
+                "page " + std::to_string(page) + " stays in the pool after the spill");
+        }
+
+        CompressedPool disabled(store, pageSize, 0);
+        results.expect(!disabled.isEnabled() && !disabled.store(4, 0, patterns[0].page.data()) && !disabled.contains(4, 0),
+            "a zero-capacity pool stores nothing");
+
+        std::remove(SCRATCH_STORE.c_str());
+        return results.finish();
+    }
+}
@@ -0,0 +1,118 @@
+#include "TLB.h"
+#include <algorithm>
+
+TLB::TLB(int entryCount, int hugePageFrames) : hugePageFrames(std::max(hugePageFrames, 1)) {
+    ways = entryCount < WAYS ? std::max(entryCount, 0) : WAYS;
+    setCount = ways > 0 ? entryCount / ways : 0;
+    entries.resize(static_cast<size_t>(setCount) * ways);
+    nextVictim.resize(setCount, 0);
+}
+
+TLB::Entry* TLB::findEntry(int processId, int pageNumber, bool huge) {
+    Entry* set = &entries[static_cast<size_t>(setFor(pageNumber, huge)) * ways];
+    for (int way = 0; way < ways; ++way) {
+        Entry& entry = set[way];
+        if (entry.valid && entry.pageNumber == pageNumber && entry.processId == processId && entry.huge == huge) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+TLB::Entry* TLB::findHugeEntry(int processId, int pageNumber) {
+    if (hugePageFrames <= 1) {
+        return nullptr;
+    }
+    return findEntry(processId, pageNumber - pageNumber % hugePageFrames, true);
+}
+
+int TLB::lookup(int processId, int pageNumber) {
+    if (!isEnabled()) {
+        return -1;
+    }
+    if (Entry* entry = findEntry(processId, pageNumber, false)) {
+        hitCount++;
+        return entry->frameNumber;
+    }
+    if (Entry* entry = findHugeEntry(processId, pageNumber)) {
+        hitCount++;
+        hugeHitCount++;
+        return entry->frameNumber + pageNumber % hugePageFrames;
+    }
+    missCount++;
+    return -1;
+}
+
+void TLB::insert(int processId, int pageNumber, int frameNumber, bool huge) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    // A huge page is cached once, by its first page and frame
+    huge = huge && hugePageFrames > 1;
+    if (huge) {
+        frameNumber -= pageNumber % hugePageFrames;
+        pageNumber -= pageNumber % hugePageFrames;
+    }
+
+    // Refresh an existing translation in place; otherwise take a free way, else rotate through the set
+    Entry* entry = findEntry(processId, pageNumber, huge);
+    if (!entry) {
+        int set = setFor(pageNumber, huge);
+        Entry* setEntries = &entries[static_cast<size_t>(set) * ways];
+        auto freeWay = std::find_if(setEntries, setEntries + ways, [](const Entry& e) { return !e.valid; });
+        if (freeWay != setEntries + ways) {
+            entry = freeWay;
+        }
+        else {
+            int victim = nextVictim[set];
+            nextVictim[set] = (victim + 1) % ways;
+            entry = &setEntries[victim];
+        }
+    }
+
+    entry->valid = false;
+    entry->processId = processId;
+    entry->pageNumber = pageNumber;
+    entry->frameNumber = frameNumber;
+    entry->huge = huge;
+    entry->valid = true;
+}
+
+bool TLB::invalidate(int processId, int pageNumber) {
+    if (!isEnabled()) {
+        return false;
+    }
+    bool dropped = false;
+    for (Entry* entry : { findEntry(processId, pageNumber, false), findHugeEntry(processId, pageNumber) }) {
+        if (entry) {
+            entry->valid = false;
+            dropped = true;
+        }
+    }
+    return dropped;
+}
+
+void TLB::shootdown(int processId, int pageNumber) {
+    if (invalidate(processId, pageNumber)) {
+        shootdownCount++;
+    }
+}
+
+void TLB::switchTo(int processId) {
+    if (currentProcess == processId) {
+        return;
+    }
+    currentProcess = processId;
+    flush();
+}
+
+void TLB::flush() {
+    if (!isEnabled()) {
+        return;
+    }
+    for (Entry& entry : entries) {
+        entry.valid = false;
+    }
+    flushCount++;
+}
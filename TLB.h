@@ -0,0 +1,62 @@
+#pragma once
+#include "AtomicField.h"
+#include <atomic>
+#include <vector>
+
+// Software TLB for one simulated core: a small set-associative cache of
+// (pid, page) -> frame translations indexed by page number. A huge page takes a
+// single entry, tagged with its first page, that covers hugePageFrames pages. The core fills it
+// after a page-table walk, switchTo() flushes it when a different process is
+// dispatched, and evictions shoot down the matching entry on every core.
+// Entries may briefly go stale when an eviction races a fill; callers re-check
+// the frame's owner on access and invalidate the entry when it no longer matches.
+class TLB {
+public:
+    static const int WAYS = 4;
+
+    TLB(int entryCount, int hugePageFrames);   // Entries round down to whole sets; 0 disables the TLB
+
+    bool isEnabled() const { return !entries.empty(); }
+    int getEntryCount() const { return static_cast<int>(entries.size()); }
+
+    int lookup(int processId, int pageNumber);     // Frame number, or -1 on a miss
+    void insert(int processId, int pageNumber, int frameNumber, bool huge);
+    bool invalidate(int processId, int pageNumber); // Drops the page's entry and any huge entry covering it
+    void shootdown(int processId, int pageNumber);  // Invalidation on behalf of an eviction
+    void switchTo(int processId);                   // Context switch: flushes unless the same process returns
+    void flush();
+
+    // Statistics
+    long long getHitCount() const { return hitCount.load(); }
+    long long getHugeHitCount() const { return hugeHitCount.load(); }  // Hits served by a huge-page entry
+    long long getMissCount() const { return missCount.load(); }
+    long long getShootdownCount() const { return shootdownCount.load(); }
+    long long getFlushCount() const { return flushCount.load(); }
+
+private:
+    struct Entry {
+        AtomicField<bool> valid = false;
+        AtomicField<int> processId = -1;
+        AtomicField<int> pageNumber = -1;
+        AtomicField<int> frameNumber = -1;
+        AtomicField<bool> huge = false;     // Covers hugePageFrames pages starting at pageNumber
+    };
+
+    // Huge entries index by huge-page number so aligned first pages spread across the sets
+    int setFor(int pageNumber, bool huge) const { return (huge ? pageNumber / hugePageFrames : pageNumber) % setCount; }
+    Entry* findEntry(int processId, int pageNumber, bool huge);
+    Entry* findHugeEntry(int processId, int pageNumber); // Huge entry covering pageNumber, if any
+
+    int hugePageFrames;                 // Pages per huge page (1 = huge pages off)
+    int ways;
+    int setCount;
+    std::vector<Entry> entries;                 // entries[set * ways + way]
+    std::vector<AtomicField<int>> nextVictim;   // Round-robin replacement cursor per set
+    AtomicField<int> currentProcess = -1;       // Process the cached translations belong to
+
+    std::atomic<long long> hitCount{ 0 };
+    std::atomic<long long> hugeHitCount{ 0 };
+    std::atomic<long long> missCount{ 0 };
+    std::atomic<long long> shootdownCount{ 0 };
+    std::atomic<long long> flushCount{ 0 };
+};
@@ -8,11 +8,12 @@
 #include <thread>
 #include <random>
 #include <algorithm>
+#include <cstring>
 
 
     // Constructor: initializes all fields and generates random instructions
 Process::Process(const std::string& name, int id, int numInstructions, int memorySize,
-    const std::string& customInstructions)
+    const std::string& customInstructions, int programSeed)
     : name(name), id(id), totalInstructions(numInstructions),
     remainingInstructions(numInstructions), status(ProcessStatus::Waiting),
     assignedCore(-1), currentInstructionIndex(0), sleepCyclesRemaining(0),
@@ -20,41 +21,60 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
 
     creationTime = getTimestamp();
 
-    // Initialize page table
-    int numPages = memoryRequirement / Config::getMemPerFrame();
-    for (int i = 0; i < numPages; ++i) {
-        pageTable[i] = { -1, false, false };
-    }
+    // Page table leaves are allocated as pages are first mapped
+
+    // Code pages follow the data pages so instruction fetches never alias variables or READ/WRITE targets
+    pageSize = Config::getMemPerFrame();
+    codeSegmentStart = (memoryRequirement + pageSize - 1) / pageSize;
+    readahead = { codeSegmentStart, 0 };
 
     if (!customInstructions.empty()) {
         try {
             // Parse and set custom instructions
-            setCustomInstructions(customInstructions);
+            setCustomInstructions(customInstructions, numInstructions);
         }
         catch (const std::exception& e) {
             std::ostringstream entry;
             entry << getTimestamp() << " Core:" << assignedCore
                 << " ERROR: Invalid instructions: " << e.what();
             logs.push_back(entry.str());
-
-            // Fall back to random instructions if custom instructions failed
-            generateRandomInstructions(numInstructions);
         }
     }
-    else {
-        // Generate random instructions as usual
-        int maxForLoops = 3;
-        int reservedForEndInstructions = maxForLoops;
-        int actualInstructionsToGenerate = numInstructions - reservedForEndInstructions;
-        generateRandomInstructions(actualInstructionsToGenerate);
+
+    if (!program) {
+        int seed = programSeed >= 0 ? programSeed : ProgramCache::pickSeed();
+        program = ProgramCache::generate(static_cast<uint32_t>(seed), numInstructions, memoryRequirement);
     }
+}
+
+Process::Process(const Process& parent, const std::string& name, int id)
+    : name(name), id(id), totalInstructions(parent.totalInstructions),
+    remainingInstructions(parent.remainingInstructions),
+    status(parent.sleepCyclesRemaining > 0 ? ProcessStatus::Sleeping : ProcessStatus::Waiting),
+    assignedCore(-1), lastCore(-1), migrationCount(0), warmupTicksRemaining(0),
+    memoryRequirement(parent.memoryRequirement),
+    pageSize(parent.pageSize), codeSegmentStart(parent.codeSegmentStart), readahead(parent.readahead),
+    program(parent.program), currentInstructionIndex(parent.currentInstructionIndex),
+    variableAddresses(parent.variableAddresses), nextVariableAddress(parent.nextVariableAddress),
+    forLoopStack(parent.forLoopStack), forCounterStack(parent.forCounterStack),
+    sleepCyclesRemaining(parent.sleepCyclesRemaining), faultRetries(0) {
+
+    creationTime = getTimestamp();
+
+    // The parent's logs and PRINT output stay with the parent; the child's log starts at the fork
+    std::ostringstream entry;
+    entry << creationTime << " Core:" << assignedCore << " Forked from " << parent.name
+        << " at line " << (totalInstructions - remainingInstructions);
+    logs.push_back(entry.str());
+}
 
-    // Fill any remaining slots with PRINT instructions if needed
-    int unusedSlots = numInstructions - static_cast<int>(instructions.size());
-    for (int i = 0; i < unusedSlots; i++) {
-        Instruction instr(InstructionType::PRINT);
-        instr.arg1 = "Hello world from " + name + "!";
-        instructions.push_back(instr);
+void Process::setMemoryManager(MemoryManager* mgr) {
+    memoryManager = mgr;
+    // The code segment starts after the data pages, so it moves with the page size
+    if (mgr && mgr->getFrameSize() != pageSize) {
+        pageSize = mgr->getFrameSize();
+        codeSegmentStart = (memoryRequirement + pageSize - 1) / pageSize;
+        readahead = { codeSegmentStart, 0 };
     }
 }
 
@@ -116,7 +136,7 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
 
     // Main instruction execution method
     void Process::executeInstruction() {
-        if (remainingInstructions <= 0 || currentInstructionIndex >= static_cast<int>(instructions.size())) { // TOBEDELETED: Fix C4018 warning
+        if (remainingInstructions <= 0 || currentInstructionIndex >= static_cast<int>(program->instructions.size())) { // TOBEDELETED: Fix C4018 warning
             return;
         }
 
@@ -140,34 +160,21 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
         }
 
         // === DEMAND PAGING LOGIC ===
-        int frameSize = Config::getMemPerFrame();
-        int instructionSize = sizeof(Instruction);  // Typically 16-32 bytes depending on struct
-        int virtualPage = (currentInstructionIndex * instructionSize) / frameSize;
+        int virtualPage = getCodePage(currentInstructionIndex);
 
-        // TOBEDELETED: Check if page is present; if not, allocate it (MO2 continuous page fault handling)
-        auto& pt = this->getPageTableRef();
-        if (pt.find(virtualPage) == pt.end() || !pt[virtualPage].valid) {
-            if (memoryManager) {
-                // TOBEDELETED: Continuously retry until page is allocated (MO2 requirement)
-                while (pt.find(virtualPage) == pt.end() || !pt[virtualPage].valid) {
-                    int frameNumber = memoryManager->allocatePage(this, virtualPage);
-                    if (frameNumber >= 0) {
-                        // TOBEDELETED: Page successfully allocated
-                        break;
-                    }
-                    // TOBEDELETED: Page allocation failed, continue retrying (clock algorithm will find victim)
-                }
-            }
+        // Give up the core if any page this instruction touches is not resident; the PC stays put
+        const Instruction& currentInstr = program->instructions[currentInstructionIndex];
+        if (blockOnMissingPages(currentInstr, virtualPage)) {
+            return;
         }
 
-        // Mark this page as recently accessed (for clock replacement)
-        if (memoryManager && pt.find(virtualPage) != pt.end() && pt[virtualPage].valid) {
-            int frameNumber = pt[virtualPage].frameNumber;
-            memoryManager->markPageAccessed(frameNumber);  // Implement this in MemoryManager
+        // Fault the code page in if needed and mark it recently accessed (for clock replacement)
+        int frameNumber = resolveCodeFrame(virtualPage);
+        if (frameNumber >= 0) {
+            memoryManager->markPageAccessed(frameNumber, this, virtualPage);
         }
 
         // === EXECUTE INSTRUCTION ===
-        const Instruction& currentInstr = instructions[currentInstructionIndex];
         switch (currentInstr.type) {
         case InstructionType::PRINT:     executePrintInstruction(currentInstr); break;
         case InstructionType::DECLARE:   executeDeclareInstruction(currentInstr); break;
@@ -182,127 +189,14 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
 
         currentInstructionIndex++;
         remainingInstructions--;
+        faultRetries = 0;
 
-        if (remainingInstructions == 0 || currentInstructionIndex >= static_cast<int>(instructions.size())) { // TOBEDELETED: Fix C4018 warning
+        if (remainingInstructions == 0 || currentInstructionIndex >= static_cast<int>(program->instructions.size())) { // TOBEDELETED: Fix C4018 warning
             status = ProcessStatus::Finished;
         }
     }
 
 
-    void Process::generateRandomInstructions(int numInstructions) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> instrTypeDist(0, 8); // Now 9 instruction types
-        std::uniform_int_distribution<> valueDist(1, 100);
-        std::uniform_int_distribution<> forRepeatsDist(2, 5);
-        std::uniform_int_distribution<> sleepDist(1, 10);
-        
-        instructions.clear();
-        instructions.reserve(totalInstructions); // Reserve full space including potential FOR_ENDs
-        
-        int forNestingLevel = 0;
-        std::vector<int> forStartPositions;
-        
-        for (int i = 0; i < numInstructions && static_cast<int>(instructions.size()) < totalInstructions; i++) { // TOBEDELETED: Fix C4018 warning
-            InstructionType instrType = static_cast<InstructionType>(instrTypeDist(gen));
-            
-            // Limit FOR loop nesting to 3 levels and prevent new FOR loops if close to instruction limit
-            if (instrType == InstructionType::FOR_START && 
-                (forNestingLevel >= 3 || static_cast<int>(instructions.size()) >= totalInstructions - static_cast<int>(forStartPositions.size()))) { // TOBEDELETED: Fix C4018 warning
-                instrType = InstructionType::PRINT; // Default to PRINT instead
-            }
-            
-            Instruction instr(instrType);
-            
-            switch (instrType) {
-                case InstructionType::PRINT: {
-                    // Generate PRINT with variable or simple message
-                    // TOBEDELETED: Fix undeclared 'variables' - use variableAddresses instead
-                    if (variableAddresses.empty() || valueDist(gen) % 2 == 0) {
-                        instr.arg1 = "Hello world from " + name + "!";
-                    } else {
-                        // Print a variable
-                        auto varIt = variableAddresses.begin();
-                        std::advance(varIt, valueDist(gen) % variableAddresses.size());
-                        instr.arg1 = "Value from: " + varIt->first;
-                    }
-                    break;
-                }
-                case InstructionType::DECLARE: {
-                    instr.arg1 = generateRandomVariableName();
-                    instr.value = valueDist(gen);
-                    break;
-                }
-                case InstructionType::ADD:
-                case InstructionType::SUBTRACT: {
-                    instr.arg1 = generateRandomVariableName(); // Result variable
-                    instr.arg2 = generateRandomVariableName(); // First operand
-                    if (valueDist(gen) % 2 == 0) {
-                        instr.arg3 = generateRandomVariableName(); // Variable operand
-                    } else {
-                        instr.value = valueDist(gen); // Numeric operand
-                    }
-                    break;
-                }
-                case InstructionType::SLEEP: {
-                    instr.value = sleepDist(gen);
-                    break;
-                }
-                case InstructionType::FOR_START: {
-                    instr.value = forRepeatsDist(gen);
-                    instr.forLevel = forNestingLevel;
-                    forStartPositions.push_back(i);
-                    forNestingLevel++;
-                    break;
-                }
-                case InstructionType::FOR_END: {
-                    if (!forStartPositions.empty()) {
-                        forNestingLevel--;
-                        instr.forLevel = forNestingLevel;
-                        forStartPositions.pop_back();
-                    } else {
-                        // No matching FOR_START, convert to PRINT
-                        instr.type = InstructionType::PRINT;
-                        instr.arg1 = "Hello world from " + name + "!";
-                    }
-                    break;
-                }
-                case InstructionType::READ: {
-                    instr.arg1 = generateRandomVariableName(); // Variable to store result
-                    std::ostringstream addressStream;
-                    addressStream << "0x" << std::hex << (gen() % (static_cast<uint32_t>(memoryRequirement) * static_cast<uint32_t>(Config::getMemPerFrame()))); // TOBEDELETED: Fix signed/unsigned 
-                    instr.arg2 = addressStream.str();
-                    break;
-                }
-                case InstructionType::WRITE: {
-                    std::ostringstream addressStream;
-                    addressStream << "0x" << std::hex << (gen() % (static_cast<uint32_t>(memoryRequirement) * static_cast<uint32_t>(Config::getMemPerFrame()))); // TOBEDELETED: Fix signed/unsigned 
-                    instr.arg1 = addressStream.str();
-                    instr.value = valueDist(gen); // Random value to write
-                    break;
-                }
-            }
-            
-            instructions.push_back(instr);
-        }
-        
-        // Close any unclosed FOR loops, but only if we have space
-        while (!forStartPositions.empty() && static_cast<int>(instructions.size()) < totalInstructions) { // TOBEDELETED: Fix C4018 warning
-            Instruction endInstr(InstructionType::FOR_END);
-            endInstr.forLevel = --forNestingLevel;
-            instructions.push_back(endInstr);
-            forStartPositions.pop_back();
-            // Don't increment totalInstructions or remainingInstructions anymore
-        }
-        
-        // Fill any remaining slots with PRINT instructions
-        while (static_cast<int>(instructions.size()) < totalInstructions) { // TOBEDELETED: Fix C4018 warning
-            Instruction instr(InstructionType::PRINT);
-            instr.arg1 = "Hello world from " + name + "!";
-            instructions.push_back(instr);
-        }
-    }
-
     void Process::executePrintInstruction(const Instruction& instr) {
         std::ostringstream entry;
         entry << getTimestamp() << " Core:" << assignedCore << " ";
@@ -314,6 +208,10 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
             std::string result = evaluateStringExpression(instr.arg1);
             entry << "\"" << result << "\"";
             printOutput = result; // TOBEDELETED: Store the actual output
+        } else if (instr.arg2 == "GREETING") {
+            std::string greeting = "Hello world from " + name + "!";
+            entry << "\"" << greeting << "\"";
+            printOutput = greeting;
         } else if (instr.arg1.find("Value from:") == 0) {
             // Extract variable name and print its value
             std::string varName = instr.arg1.substr(12); // Remove "Value from: "
@@ -467,15 +365,6 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
         writeMemoryValue(address, clampedValue);
     }
 
-    std::string Process::generateRandomVariableName() {
-        static std::vector<std::string> varNames = {"x", "y", "z", "a", "b", "c", "counter", "temp", "result", "sum"};
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dist(0, static_cast<int>(varNames.size()) - 1);
-        
-        return varNames[dist(gen)];
-    }
-
     // How many instructions are left
     int Process::getRemainingInstructions() const {
         return remainingInstructions;
@@ -483,7 +372,7 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
 
     // Has the process completed all its work?
     bool Process::hasFinished() const {
-        return remainingInstructions == 0 || currentInstructionIndex >= static_cast<int>(instructions.size()); // TOBEDELETED: Fix C4018 warning
+        return remainingInstructions == 0 || currentInstructionIndex >= static_cast<int>(program->instructions.size()); // TOBEDELETED: Fix C4018 warning
     }
 
     // Status and core management
@@ -494,12 +383,12 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
     void Process::setStatus(ProcessStatus newStatus) {
         status = newStatus;
         // Auto-update to Finished status when no instructions remain
-        if (remainingInstructions == 0 || currentInstructionIndex >= static_cast<int>(instructions.size())) { // TOBEDELETED: Fix C4018 warning
+        if (remainingInstructions == 0 || currentInstructionIndex >= static_cast<int>(program->instructions.size())) { // TOBEDELETED: Fix C4018 warning
             status = ProcessStatus::Finished;
         }
     }
 
-    const std::unordered_map<int, PageTableEntry>& Process::getPageTable() const {
+    const PageTable& Process::getPageTable() const {
         return pageTable;
     }
 
@@ -511,6 +400,24 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
         assignedCore = coreId;
     }
 
+    bool Process::noteDispatch(int coreId, int warmupTicks) {
+        bool migrated = lastCore >= 0 && lastCore != coreId;
+        if (migrated) {
+            migrationCount++;
+            warmupTicksRemaining = warmupTicks;
+        }
+        lastCore = coreId;
+        return migrated;
+    }
+
+    bool Process::consumeWarmupTick() {
+        if (warmupTicksRemaining <= 0) {
+            return false;
+        }
+        warmupTicksRemaining--;
+        return true;
+    }
+
     const std::string& Process::getName() const {
         return name;
     }
@@ -529,67 +436,145 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
 
     bool Process::isValidMemoryAccess(uint32_t address) const {
         // Validate memory address is within process's allocated memory range
-        // TOBEDELETED: Fix signed/unsigned mismatch
-        return address < (static_cast<uint32_t>(memoryRequirement) * static_cast<uint32_t>(Config::getMemPerFrame()));
+        return address < static_cast<uint32_t>(memoryRequirement);
     }
 
-    uint16_t Process::readMemoryValue(uint32_t address) {
-        // Calculate which page this address falls in
-        int pageSize = Config::getMemPerFrame();
-        int pageNumber = address / pageSize;
+    // Pages an instruction will touch: its code page, the symbol table for variable access, and a READ/WRITE target
+    void Process::collectInstructionPages(const Instruction& instr, int codePage, std::vector<int>& pages) const {
+        pages.push_back(codePage);
 
-        // TOBEDELETED: MO2 specification - "Page fault handling continuously occurs until a valid page has been returned"
-        auto& pt = this->getPageTableRef();
-        if (pt.find(pageNumber) == pt.end() || !pt[pageNumber].valid) {
-            if (memoryManager) {
-                // TOBEDELETED: Continuously retry until page is allocated (MO2 requirement)
-                while (pt.find(pageNumber) == pt.end() || !pt[pageNumber].valid) {
-                    int frameNumber = memoryManager->allocatePage(this, pageNumber);
-                    if (frameNumber >= 0) {
-                        // TOBEDELETED: Page successfully allocated
-                        break;
-                    }
-                    // TOBEDELETED: Page allocation failed, continue retrying (clock algorithm will find victim)
-                    // TOBEDELETED: In real OS this would be a blocking operation, here we busy-wait
+        bool usesVariables = instr.type != InstructionType::SLEEP &&
+            instr.type != InstructionType::FOR_START &&
+            instr.type != InstructionType::FOR_END;
+        if (usesVariables) {
+            uint32_t symbolTableEnd = std::min(SYMBOL_TABLE_START + SYMBOL_TABLE_SIZE, static_cast<uint32_t>(memoryRequirement));
+            for (uint32_t address = SYMBOL_TABLE_START; address < symbolTableEnd; address += pageSize) {
+                pages.push_back(static_cast<int>(address / pageSize));
+            }
+        }
+
+        const std::string* addressArg = instr.type == InstructionType::READ ? &instr.arg2 :
+            instr.type == InstructionType::WRITE ? &instr.arg1 : nullptr;
+        if (addressArg) {
+            try {
+                uint32_t address = std::stoul(*addressArg, nullptr, 16) & ~1u;
+                if (isValidMemoryAccess(address)) {
+                    pages.push_back(static_cast<int>(address / pageSize));
                 }
             }
+            catch (...) {
+                // Malformed addresses are reported when the instruction executes
+            }
         }
+    }
+
+    bool Process::blockOnMissingPages(const Instruction& instr, int codePage) {
+        // Only scheduled processes block; direct execution and repeated faults on one instruction resolve inline
+        if (!memoryManager || !memoryManager->usesBlockingFaults() || assignedCore < 0 ||
+            faultRetries >= MAX_FAULT_RETRIES) {
+            return false;
+        }
+
+        std::vector<int> pages;
+        collectInstructionPages(instr, codePage, pages);
 
-        // Return the value (0 if not initialized)
-        auto it = memoryValues.find(address);
-        if (it != memoryValues.end()) {
-            return it->second;
+        std::vector<int> missingPages;
+        for (int pageNumber : pages) {
+            // A code page another process already loaded is a minor fault: mapped now, no wait for the pager
+            bool resident = pageTable.isResident(pageNumber) ||
+                (pageNumber == codePage && memoryManager->tryMapSharedCode(this, pageNumber));
+            if (!resident && std::find(missingPages.begin(), missingPages.end(), pageNumber) == missingPages.end()) {
+                missingPages.push_back(pageNumber);
+            }
+        }
+        if (missingPages.empty()) {
+            return false;
         }
-        return 0; // Return 0 for uninitialized memory
+
+        bool codeFault = std::find(missingPages.begin(), missingPages.end(), codePage) != missingPages.end();
+        faultRetries++;
+        memoryManager->queuePageFault(this, missingPages, codeFault ? codePage : -1);
+        status = ProcessStatus::PageFaultWait;
+        return true;
     }
 
-    void Process::writeMemoryValue(uint32_t address, uint16_t value) {
-        // Calculate which page this address falls in
-        int pageSize = Config::getMemPerFrame();
-        int pageNumber = address / pageSize;
+    int Process::getCodePage(int instructionIndex) const {
+        int instructionSize = sizeof(Instruction);  // Typically 16-32 bytes depending on struct
+        return codeSegmentStart + (instructionIndex * instructionSize) / pageSize;
+    }
 
+    int Process::getLastCodePage() const {
+        return getCodePage(std::max(static_cast<int>(program->instructions.size()) - 1, 0));
+    }
+
+    int Process::resolveCodeFrame(int pageNumber) {
+        if (!memoryManager) {
+            return -1;
+        }
+
+        int frameNumber = memoryManager->lookupTlb(assignedCore, id, pageNumber);
+        if (frameNumber >= 0) {
+            return frameNumber;
+        }
+
+        // A code fault also reads ahead; walk again in case the readahead evicted the page it followed
+        if (!pageTable.isResident(pageNumber)) {
+            walkPageTable(pageNumber);
+            memoryManager->readaheadCode(this, pageNumber);
+        }
+        return walkPageTable(pageNumber);
+    }
+
+    int Process::resolveFrame(int pageNumber) {
+        if (!memoryManager) {
+            return -1;
+        }
+
+        int frameNumber = memoryManager->lookupTlb(assignedCore, id, pageNumber);
+        return frameNumber >= 0 ? frameNumber : walkPageTable(pageNumber);
+    }
+
+    int Process::walkPageTable(int pageNumber) {
         // TOBEDELETED: MO2 specification - "Page fault handling continuously occurs until a valid page has been returned"
         auto& pt = this->getPageTableRef();
-        if (pt.find(pageNumber) == pt.end() || !pt[pageNumber].valid) {
-            if (memoryManager) {
-                // TOBEDELETED: Continuously retry until page is allocated (MO2 requirement)
-                while (pt.find(pageNumber) == pt.end() || !pt[pageNumber].valid) {
-                    int frameNumber = memoryManager->allocatePage(this, pageNumber);
-                    if (frameNumber >= 0) {
-                        // TOBEDELETED: Page successfully allocated
-                        break;
-                    }
-                    // TOBEDELETED: Page allocation failed, continue retrying (clock algorithm will find victim)
-                    // TOBEDELETED: In real OS this would be a blocking operation, here we busy-wait
-                }
-            }
+        const PageTableEntry* entry = pt.find(pageNumber);
+        while (!entry || !entry->valid) {
+            memoryManager->allocatePage(this, pageNumber);
+            entry = pt.find(pageNumber);
         }
 
-        // Write to memory map and mark page as dirty
-        memoryValues[address] = value;
-        if (pt.find(pageNumber) != pt.end() && pt[pageNumber].valid) {
-            pt[pageNumber].dirty = true;
-        }
+        int frameNumber = entry->frameNumber;
+        memoryManager->fillTlb(assignedCore, id, pageNumber, frameNumber, entry->huge);
+        return frameNumber;
+    }
+
+    uint16_t Process::readMemoryValue(uint32_t address) {
+        address &= ~1u;
+
+        // Another core may evict the page between translation and access; translate again if so
+        int pageNumber = address / pageSize;
+        uint16_t value = 0;
+        int frameNumber;
+        do {
+            frameNumber = resolveFrame(pageNumber);
+            if (frameNumber < 0) {
+                return 0;
+            }
+        } while (!memoryManager->readMappedWord(this, pageNumber, frameNumber, address % pageSize, value));
+        return value;
+    }
+
+    void Process::writeMemoryValue(uint32_t address, uint16_t value) {
+        address &= ~1u;
+
+        int pageNumber = address / pageSize;
+        int frameNumber;
+        do {
+            frameNumber = resolveFrame(pageNumber);
+            if (frameNumber < 0) {
+                return;
+            }
+        } while (!memoryManager->writeMappedWord(this, pageNumber, frameNumber, address % pageSize, value));
     }
 
     void Process::executeReadInstruction(const Instruction& instr) {
@@ -695,164 +680,62 @@ Process::Process(const std::string& name, int id, int numInstructions, int memor
     }
 
     uint16_t Process::getMemoryValueAt(uint32_t address) const {
+        if (!isValidMemoryAccess(address) || !memoryManager)
+            return 0;
+
+        // Peek without faulting the page in
+        address &= ~1u;
+        std::vector<uint8_t> pageData(pageSize, 0);
+        memoryManager->readPageContents(const_cast<Process*>(this), address / pageSize, pageData.data());
+
+        uint16_t value;
+        std::memcpy(&value, &pageData[address % pageSize], sizeof(value));
+        return value;
+    }
+
+    uint16_t Process::readMemoryValueAt(uint32_t address) {
         if (!isValidMemoryAccess(address))
             return 0;
-        
-        // Since this is const, we can't modify the memoryValues map
-        // to auto-create entries for uninitialized addresses
-        auto it = memoryValues.find(address);
-        if (it != memoryValues.end()) {
-            return it->second;
-        }
-        return 0; // Return 0 for uninitialized memory
+
+        return readMemoryValue(address);
     }
 
     bool Process::setMemoryValueAt(uint32_t address, uint16_t value) {
         if (!isValidMemoryAccess(address))
             return false;
-        
-        // Calculate which page this address falls in
-        int pageSize = Config::getMemPerFrame();
-        int pageNumber = address / pageSize;
 
-        // Check if we need to page in this memory
-        auto& pt = this->getPageTableRef();
-        if (pt.find(pageNumber) == pt.end() || !pt[pageNumber].valid) {
-            if (memoryManager) {
-                memoryManager->allocatePage(this, pageNumber);
-            }
-        }
-
-        // Write to memory map and mark page as dirty
-        memoryValues[address] = value;
-        if (pt.find(pageNumber) != pt.end() && pt[pageNumber].valid) {
-            pt[pageNumber].dirty = true;
-        }
+        writeMemoryValue(address, value);
         return true;
     }
 
     std::unordered_map<uint32_t, uint16_t> Process::getMemoryDump() const {
-        return memoryValues;
-    }
-
-    void Process::setCustomInstructions(const std::string& instructionsStr) {
-        instructions.clear();
-        std::vector<std::string> instructionList;
-        
-        // Split by semicolons
-        size_t pos = 0;
-        std::string input = instructionsStr;
-        while ((pos = input.find(';')) != std::string::npos) {
-            std::string instr = input.substr(0, pos);
-            instructionList.push_back(instr);
-            input.erase(0, pos + 1);
-        }
-        if (!input.empty()) {
-            instructionList.push_back(input);
-        }
-        
-        // TOBEDELETED: Validate instruction count - MO2 spec requires exact error message
-        if (instructionList.empty() || instructionList.size() > 50) {
-            // TOBEDELETED: MO2 specification: "Throws 'invalid command' if the instruction size is not met"
-            throw std::runtime_error("invalid command");
+        std::unordered_map<uint32_t, uint16_t> dump;
+        if (!memoryManager) {
+            return dump;
         }
-        
-        // Parse each instruction
-        for (const auto& instrText : instructionList) {
-            std::string trimmed = instrText;
-            trimmed.erase(0, trimmed.find_first_not_of(" \t\r\n"));
-            trimmed.erase(trimmed.find_last_not_of(" \t\r\n") + 1);
-            
-            std::stringstream ss(trimmed);
-            std::string cmd;
-            ss >> cmd;
-            
-            if (cmd == "DECLARE") {
-                std::string varName;
-                uint16_t value;
-                ss >> varName >> value;
-                
-                Instruction instr(InstructionType::DECLARE);
-                instr.arg1 = varName;
-                instr.value = value;
-                instructions.push_back(instr);
-            } 
-            else if (cmd == "ADD") {
-                std::string result, op1, op2;
-                ss >> result >> op1 >> op2;
-                
-                Instruction instr(InstructionType::ADD);
-                instr.arg1 = result;
-                instr.arg2 = op1;
-                instr.arg3 = op2;
-                instructions.push_back(instr);
-            } 
-            else if (cmd == "SUBTRACT") {
-                std::string result, op1, op2;
-                ss >> result >> op1 >> op2;
-                
-                Instruction instr(InstructionType::SUBTRACT);
-                instr.arg1 = result;
-                instr.arg2 = op1;
-                instr.arg3 = op2;
-                instructions.push_back(instr);
-            }
-            else if (cmd == "WRITE") {
-                std::string address, value;
-                ss >> address >> value;
-                
-                Instruction instr(InstructionType::WRITE);
-                instr.arg1 = address;
-                
-                // Check if value is a variable or literal
-                if (!value.empty() && std::isdigit(value[0])) {
-                    instr.value = static_cast<uint16_t>(std::stoi(value));
-                } else {
-                    instr.arg2 = value; // It's a variable name
-                }
-                instructions.push_back(instr);
-            }
-            else if (cmd == "READ") {
-                std::string varName, address;
-                ss >> varName >> address;
-                
-                Instruction instr(InstructionType::READ);
-                instr.arg1 = varName;
-                instr.arg2 = address;
-                instructions.push_back(instr);
+
+        // Collect every non-zero cell, page by page
+        int numPages = (memoryRequirement + pageSize - 1) / pageSize;
+        std::vector<uint8_t> pageData(pageSize);
+        for (int page = 0; page < numPages; ++page) {
+            if (!memoryManager->readPageContents(const_cast<Process*>(this), page, pageData.data())) {
+                continue;
             }
-            else if (trimmed.find("PRINT") == 0) {
-                // TOBEDELETED: Handle PRINT with string literals and expressions
-                size_t openParen = trimmed.find("(");
-                size_t closeParen = trimmed.find_last_of(")");
-                
-                if (openParen != std::string::npos && closeParen != std::string::npos) {
-                    std::string content = trimmed.substr(openParen + 1, closeParen - openParen - 1);
-                    
-                    Instruction instr(InstructionType::PRINT);
-                    instr.arg1 = content;
-                    
-                    // TOBEDELETED: Check if this is a string concatenation expression (contains + operator)
-                    if (content.find(" + ") != std::string::npos) {
-                        instr.arg2 = "EXPRESSION"; // TOBEDELETED: Flag for expression evaluation
-                    }
-                    
-                    instructions.push_back(instr);
+            for (int offset = 0; offset + 1 < pageSize; offset += 2) {
+                uint16_t value;
+                std::memcpy(&value, &pageData[offset], sizeof(value));
+                if (value != 0) {
+                    dump[static_cast<uint32_t>(page * pageSize + offset)] = value;
                 }
             }
-            else if (cmd == "SLEEP") {
-                uint16_t cycles;
-                ss >> cycles;
-                
-                Instruction instr(InstructionType::SLEEP);
-                instr.value = cycles;
-                instructions.push_back(instr);
-            }
         }
-        
-        // TOBEDELETED: Fix size_t to int conversion warnings
-        remainingInstructions = static_cast<int>(instructions.size());
-        totalInstructions = static_cast<int>(instructions.size());
+        return dump;
+    }
+
+    void Process::setCustomInstructions(const std::string& instructionsStr, int paddedLength) {
+        program = ProgramCache::parse(instructionsStr, paddedLength);
+        remainingInstructions = program->lineCount;
+        totalInstructions = program->lineCount;
     }
 
     std::string Process::evaluateStringExpression(const std::string& expression) {
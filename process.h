@@ -8,49 +8,27 @@
 #include <cstdint>
 #include <unordered_map>
 #include "Config.h"
+#include "PageTable.h"
+#include "ProgramCache.h"
 
 class MemoryManager; // Forward declaration for MemoryManager
-struct PageTableEntry {
-    int frameNumber;   // -1 if not in memory
-    bool valid;        // true if page is in physical memory
-    bool dirty;        // optional, for write tracking
-};
 
+// Per-process sequential readahead over the code segment (adapted by MemoryManager::readaheadCode)
+struct ReadaheadState {
+    int nextExpectedPage;  // Code page a sequential stream would fault on next
+    int window;            // Pages to prefetch after the next sequential fault
+};
 
 // Process status enumeration
 enum class ProcessStatus {
     Waiting,    
     Running,    
     Sleeping,   // Process is sleeping and should relinquish CPU
+    PageFaultWait, // Process is blocked until the pager maps its faulting pages
+    Suspended,  // Swapped out by load control or the medium-term scheduler
     Finished    
 };
 
-// Instruction types for the process programming language
-enum class InstructionType {
-    PRINT,
-    DECLARE,
-    ADD,
-    SUBTRACT,
-    SLEEP,
-    FOR_START,
-    FOR_END,
-    READ,
-    WRITE
-};
-
-
-// Individual instruction structure
-struct Instruction {
-    InstructionType type;
-    std::string arg1;       // Variable name, message, or operand
-    std::string arg2;       // Second operand (for ADD/SUBTRACT)
-    std::string arg3;       // Third operand (for ADD/SUBTRACT)
-    uint16_t value;         // Numeric value (for DECLARE, SLEEP, FOR repeats)
-    int forLevel;           // Nesting level for FOR loops (0-2)
-    
-    Instruction(InstructionType t) : type(t), value(0), forLevel(0) {}
-};
-
 // A simple Process class that tracks execution instructions, logs, and progress.
 class Process {
 private:
@@ -61,14 +39,20 @@ private:
     std::vector<std::string> logs;      // Stored log entries
     ProcessStatus status;         // Current execution status
     int assignedCore;             // Which CPU core is running this (-1 if none)
+    int lastCore = -1;            // Core it was last dispatched to, kept while it is off-core (-1 if never run)
+    int migrationCount = 0;       // Dispatches to a different core than the last one
+    int warmupTicksRemaining = 0; // Ticks left refilling a cold cache after a migration
     std::string creationTime;     // Timestamp when process was created
-    int memoryRequirement;        // Memory requirement in pages
+    int memoryRequirement;        // Size of the process's virtual address space in bytes
 
 
-    std::unordered_map<int, PageTableEntry> pageTable;
+    PageTable pageTable;
+    int pageSize;                 // Bytes per page: mem-per-frame until attached to a memory manager, then its frame size
+    int codeSegmentStart;         // First code page; instructions live after the data pages
+    ReadaheadState readahead;
 
     // Process instruction system
-    std::vector<Instruction> instructions;              // Generated instruction sequence
+    std::shared_ptr<const ProgramImage> program;        // Shared with every process running the same code
     int currentInstructionIndex;                        // Current instruction being executed
     std::map<std::string, uint32_t> variableAddresses;
     uint32_t nextVariableAddress;
@@ -77,6 +61,8 @@ private:
     std::vector<int> forLoopStack;                      // Stack for nested FOR loops
     std::vector<int> forCounterStack;                   // Current iteration counters
     int sleepCyclesRemaining;                           // For SLEEP instruction
+    int faultRetries = 0;                               // Blocking faults taken by the current instruction
+    static const int MAX_FAULT_RETRIES = 3;             // After this many, fault inline so the instruction can't livelock
 
 
 private:
@@ -85,9 +71,14 @@ private:
     uint32_t memoryViolationAddress = 0;
 
 public:
-    // Constructor: initializes all fields and generates random instructions
+    // Constructor: initializes all fields and generates random instructions from programSeed
+    // (-1 draws one with ProgramCache::pickSeed)
     Process(const std::string& name, int id, int numInstructions, int memorySize,
-        const std::string& customInstructions = "");
+        const std::string& customInstructions = "", int programSeed = -1);
+    // Fork: shares the parent's program and copies its registers and any sleep left (a child of a sleeping
+    // parent starts Sleeping); MemoryManager::forkAddressSpace shares its pages. Logs and PRINT output are
+    // not inherited: the child's log opens with a "Forked from" entry.
+    Process(const Process& parent, const std::string& name, int id);
 
 
     void printProcess() const;
@@ -95,6 +86,7 @@ public:
     void displayLogs() const;
     void executeInstruction();
     int getRemainingInstructions() const;
+    int getSleepCyclesRemaining() const { return sleepCyclesRemaining; }
     bool hasFinished() const;
     ProcessStatus getStatus() const;
     
@@ -106,26 +98,36 @@ public:
 
     int getMemorySize() const { return memoryRequirement; }
     void setAssignedCore(int coreId);
+    // Core affinity: records a dispatch, charging warmupTicks if it moved the process to another core
+    bool noteDispatch(int coreId, int warmupTicks);  // Returns true on a migration
+    bool consumeWarmupTick();                        // True while the process is stalled on a cold cache
+    int getLastCore() const { return lastCore; }
+    int getMigrationCount() const { return migrationCount; }
     const std::string& getName() const;
     int getId() const;
     int getTotalInstructions() const;
     const std::string& getCreationTime() const;
-    const std::unordered_map<int, PageTableEntry>& getPageTable() const;
-    std::unordered_map<int, PageTableEntry>& getPageTableRef() {
+    const PageTable& getPageTable() const;
+    PageTable& getPageTableRef() {
         return pageTable;
     }
-    void setMemoryManager(MemoryManager* mgr) {
-        memoryManager = mgr;
-    }
+    int getCodePage(int instructionIndex) const;
+    int getCodeSegmentStart() const { return codeSegmentStart; }
+    int getLastCodePage() const;
+    ReadaheadState& getReadaheadState() { return readahead; }
+    // Pages are the manager's frames, so attach before the first memory access
+    void setMemoryManager(MemoryManager* mgr);
     bool setVariable(const std::string& varName, uint16_t value) {
         setVariableValue(varName, value);
         return true;
     }
 
     uint16_t getMemoryValueAt(uint32_t address) const;
+    uint16_t readMemoryValueAt(uint32_t address);  // Faults the page in, unlike getMemoryValueAt
     bool setMemoryValueAt(uint32_t address, uint16_t value);
     std::unordered_map<uint32_t, uint16_t> getMemoryDump() const;
-    void setCustomInstructions(const std::string& instructionsStr);
+    void setCustomInstructions(const std::string& instructionsStr, int paddedLength = 0);
+    const ProgramImage& getProgram() const { return *program; }
 
     // Add these accessor methods
     bool wasTerminatedDueToMemoryViolation() const { return terminatedDueToMemoryViolation; }
@@ -145,7 +147,6 @@ public:
 
 private:
     // Instruction system helper methods
-    void generateRandomInstructions(int numInstructions);
     void executePrintInstruction(const Instruction& instr);
     void executeDeclareInstruction(const Instruction& instr);
     void executeAddInstruction(const Instruction& instr);
@@ -157,13 +158,17 @@ private:
 
     uint16_t getVariableValue(const std::string& varName);
     void setVariableValue(const std::string& varName, uint16_t value);
-    std::string generateRandomVariableName();
     std::string formatInstructionForLog(const Instruction& instr);
     
 
     std::string evaluateStringExpression(const std::string& expression);
 
-    std::unordered_map<uint32_t, uint16_t> memoryValues; // Address -> Value
+    // Memory values live in the MemoryManager's physical frames; uint16 cells are 2-byte aligned
+    int resolveFrame(int pageNumber);       // Core's TLB first, then the page table
+    int resolveCodeFrame(int pageNumber);
+    int walkPageTable(int pageNumber);      // Faults the page in if needed and caches the translation
+    void collectInstructionPages(const Instruction& instr, int codePage, std::vector<int>& pages) const;
+    bool blockOnMissingPages(const Instruction& instr, int codePage);
     uint16_t readMemoryValue(uint32_t address);
     void writeMemoryValue(uint32_t address, uint16_t value);
     void executeReadInstruction(const Instruction& instr);